@@ -1,152 +1,218 @@
 #include "level.h"
 #include <stdlib.h>
-#include "../enemies/mummy/mummy.h"
-#include "../enemies/slime/slime.h"
-#include "../enemies/shurikenDude/shurikenDude.h"
 #include "../ui/ui.h"
 #include "../bgm/bgmHandler.h"
+#include "../bgm/voiceManager.h"
 #include "../items/item.h"
+#include "../debug/perf.h"
+#include "../memory/arena.h"
+#include "../texture/textureFormat.h"
+#include "../texture/textureResidency.h"
+#include "../enemies/enemyArchetype.h"
+#include "../render/renderSnapshot.h"
+#include "../map/mapRaycast.h"
+#include "../render/qualityGovernor.h"
+#include <string.h>
+
+// Streamed maps: frames of movement the background loads run ahead, and a margin
+// around the required region so standing next to a chunk border loads the neighbour
+#define LEVEL_STREAM_LOOKAHEAD 90
+#define LEVEL_STREAM_PAD 128
+
+// Map JSON + DOM, enemy store and frame arrays of one level. A level2 parse
+// peaks at roughly 350 KB, the blocks stay allocated across level switches.
+#define LEVEL_ARENA_BLOCK_SIZE (128 * 1024)
 
-#define MAX_ENEMIES 5
-
-BGMHandler bgm;
 SFX sfx;
 
+// Lives outside Level: LevelHandler/Level are copied by value, while
+// cute_tiled and the enemy store keep pointers to the arena.
+static Arena level_arena;
+static bool level_arena_ready = false;
+
 extern void debug_log(const char *format, ...);
+extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
+
+typedef struct {
+    Level* level;
+    int type_counts[ENEMY_TYPE_MAX];
+    int enemy_count;
+} LevelSpawnCount;
+
+static void level_count_spawn(void* ctx, int gid, int tx, int ty) {
+    LevelSpawnCount* count = ctx;
+    // HIER LOGGEN WIR DIE GIDS, DIE DU HÄNDISCH EINGETRAGEN HAST
+    int shape = get_tile_shape(&count->level->map, gid);
+    int type = enemy_archetype_for_shape(shape);
+    if (type >= 0) {
+        count->type_counts[type]++;
+        count->enemy_count++;
+    }
+    // Logge nur Spezial-GIDs, um das Log nicht zu fluten
+    if (gid >= 687) {
+        debug_log("FOUND_GID: %d at %d,%d -> Shape: %d", gid, tx, ty, shape);
+    }
+}
 
-bool all_enemies_dead(Level* level) {
-    if (!level) return true;
-    for (int i = 0; i < level->enemy_count; i++) {
-        if (!level->enemies[i]->entity.is_dead) {
-            return false;
-        }
+static void level_spawn_tile(void* ctx, int gid, int tx, int ty) {
+    Level* level = ctx;
+    int shape = get_tile_shape(&level->map, gid);
+    int world_x = tx * 16;
+    int world_y = ty * 16;
+    int type = enemy_archetype_for_shape(shape);
+
+    if (shape == SHAPE_PLAYER_SPAWN) {
+        level->player->entity.rect.x = world_x;
+        level->player->entity.rect.y = (world_y + 16) - level->player->entity.rect.h - 2;
+        debug_log("SPAWN_PLAYER: %d, %d", world_x, world_y);
+    }
+    else if (shape == SHAPE_CHEST) {
+        level->chest_spawn_x = world_x;
+        level->chest_spawn_y = world_y - 18;
+        debug_log("SPAWN_CHEST: %d, %d", world_x, world_y);
+    }
+    else if (type >= 0) {
+        int idx = enemy_store_spawn(&level->enemies, type, world_x, world_y);
+        debug_log("SPAWN_ENEMY: Typ %s, Index %d", enemy_archetype_name(type), idx);
     }
-    return true;
 }
 
+// Spawn markers live in the Collision layer; on streamed maps every chunk is read once here,
+// so the whole level is spawned up front and sleeps until the camera gets close
 void level_scan_entities(Level* level, SDL_Renderer* renderer) {
-    if (!level || !level->map.collision_layer) {
+    if (!level || (!level->map.collision_layer && !level->map.stream)) {
         debug_log("SCAN_ERROR: Kein Collision Layer vorhanden!");
         return;
     }
 
-    cute_tiled_layer_t* col = level->map.collision_layer;
-    debug_log("SCAN_START: Layer %dx%d", col->width, col->height);
-
-    // 1. Count Enemies
-    int enemy_count = 0;
-    for (int i = 0; i < col->width * col->height; i++) {
-        // HIER LOGGEN WIR DIE GIDS, DIE DU HÄNDISCH EINGETRAGEN HAST
-        int gid = col->data[i];
-        if (gid > 0) {
-            int shape = get_tile_shape(&level->map, gid);
-            if (shape == SHAPE_ZOMBIE_SPAWN || shape == SHAPE_SLIME_SPAWN || shape == SHAPE_SHURIKENDUDE_SPAWN) {
-                enemy_count++;
-            }
-            // Logge nur Spezial-GIDs, um das Log nicht zu fluten
-            if (gid >= 687) {
-                debug_log("FOUND_GID: %d at index %d -> Shape: %d", gid, i, shape);
-            }
-        }
-    }
+    debug_log("SCAN_START: Layer %dx%d", level->map.width, level->map.height);
+
+    // 1. Count Enemies per type, the store keeps each type contiguous
+    LevelSpawnCount count = { level, {0}, 0 };
+    map_for_each_collision_tile(&level->map, level_count_spawn, &count);
+    int* type_counts = count.type_counts;
+    int enemy_count = count.enemy_count;
 
     debug_log("SCAN_INFO: Enemies gezaehlt: %d", enemy_count);
-    level->enemy_count = enemy_count;
 
-    if (enemy_count > 0) {
-        level->enemies = malloc(sizeof(Enemy*) * enemy_count);
-        // SICHERHEIT: Array nullen, damit wir keine wilden Pointer haben
-        for(int i=0; i<enemy_count; i++) level->enemies[i] = NULL;
-    } else {
-        level->enemies = NULL;
+#if defined(ENEMY_BENCH_COUNT) && ENEMY_BENCH_COUNT > 0
+    // Stress test: pad every type that appears in the map up to ENEMY_BENCH_COUNT enemies in total
+    int bench_base[ENEMY_TYPE_MAX];
+    memcpy(bench_base, type_counts, sizeof(bench_base));
+    for (int n = enemy_count, t = 0; enemy_count > 0 && n < ENEMY_BENCH_COUNT; t = (t + 1) % ENEMY_TYPE_MAX) {
+        if (bench_base[t] > 0) { type_counts[t]++; n++; }
+    }
+#endif
+
+    int world_w = map_pixel_width(&level->map);
+    int world_h = map_pixel_height(&level->map);
+    enemy_store_init(&level->enemies, type_counts, world_w, world_h, &level_arena);
+    enemy_store_load_types(&level->enemies, renderer);
+
+    // One projectile pool for the level, every ranged type registers its sprite as a kind
+    int projectile_capacity = PROJECTILE_POOL_CAPACITY;
+#if defined(PROJECTILE_BENCH_COUNT) && PROJECTILE_BENCH_COUNT > PROJECTILE_POOL_CAPACITY
+    projectile_capacity = PROJECTILE_BENCH_COUNT;
+#endif
+    projectile_pool_init(&level->projectiles, projectile_capacity, world_w, world_h, &level_arena);
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        const EnemyTypeInfo* info = level->enemies.types[t];
+        level->enemies.projectile_kind[t] = -1;
+        if (!info || info->projectile.count == 0) continue;
+        level->enemies.projectile_kind[t] = projectile_pool_add_kind(&level->projectiles, &info->projectile, info->projectile_w, info->projectile_h);
     }
 
     // 2. Iterate and Spawn
-    int enemy_idx = 0;
-    for (int y = 0; y < col->height; y++) {
-        for (int x = 0; x < col->width; x++) {
-            int index = y * col->width + x;
-            int gid = col->data[index];
-            if (gid <= 0) continue;
-
-            int shape = get_tile_shape(&level->map, gid);
-            int world_x = x * 16;
-            int world_y = y * 16;
-
-            if (shape == SHAPE_PLAYER_SPAWN) {
-                level->player->entity.rect.x = world_x;
-                level->player->entity.rect.y = (world_y + 16) - level->player->entity.rect.h - 2;
-                debug_log("SPAWN_PLAYER: %d, %d", world_x, world_y);
-            }
-            else if (shape == SHAPE_CHEST) {
-                level->chest_spawn_x = world_x;
-                level->chest_spawn_y = world_y - 18;
-                debug_log("SPAWN_CHEST: %d, %d", world_x, world_y);
-            }
-            else if (shape == SHAPE_ZOMBIE_SPAWN || shape == SHAPE_SLIME_SPAWN || shape == SHAPE_SHURIKENDUDE_SPAWN) {
-                if (enemy_idx < enemy_count) {
-                    if (shape == SHAPE_ZOMBIE_SPAWN) {
-                        Mummy* m = malloc(sizeof(Mummy));
-                        *m = mummy_init(renderer, world_x, world_y);
-                        m->base.base.entity.rect.y = (world_y + 16) - m->base.base.entity.rect.h - 2;
-                        m->base.base.spawn_x = m->base.base.entity.rect.x;
-                        m->base.base.spawn_y = m->base.base.entity.rect.y;
-                        level->enemies[enemy_idx++] = &m->base.base;
-                        debug_log("SPAWN_MUMMY: Index %d", enemy_idx-1);
-                    } 
-                    else if (shape == SHAPE_SLIME_SPAWN) {
-                        Slime* s = malloc(sizeof(Slime));
-                        *s = slime_init(renderer, world_x, world_y);
-                        s->base.base.entity.rect.y = (world_y + 16) - s->base.base.entity.rect.h - 2;
-                        s->base.base.spawn_x = s->base.base.entity.rect.x;
-                        s->base.base.spawn_y = s->base.base.entity.rect.y;
-                        level->enemies[enemy_idx++] = &s->base.base;
-                        debug_log("SPAWN_SLIME: Index %d", enemy_idx-1);
-                    }
-                    else if (shape == SHAPE_SHURIKENDUDE_SPAWN) {
-                        ShurikenDude* s = malloc(sizeof(ShurikenDude));
-                        *s = shurikenDude_init(renderer, world_x, world_y);
-                        s->base.base.entity.rect.y = (world_y + 16) - s->base.base.entity.rect.h - 2;
-                        s->base.base.spawn_x = s->base.base.entity.rect.x;
-                        s->base.base.spawn_y = s->base.base.entity.rect.y;
-                        level->enemies[enemy_idx++] = &s->base.base;
-                        debug_log("SPAWN_SHURIKEN: Index %d", enemy_idx-1);
-                    }
-                    // ... analog für Slime
-                }
-            }
+    map_for_each_collision_tile(&level->map, level_spawn_tile, level);
+
+#if defined(ENEMY_BENCH_COUNT) && ENEMY_BENCH_COUNT > 0
+    // Clones of the real spawns, spread out to the right of them
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        EnemyStore* store = &level->enemies;
+        for (int n = 0; store->type_count[t] < store->type_capacity[t]; n++) {
+            SDL_Point origin = store->spawn[store->type_begin[t] + n % bench_base[t]];
+            int world_y = origin.y + store->rect[store->type_begin[t]].h + 2 - 16;
+            enemy_store_spawn(store, t, origin.x + 8 * (n + 1), world_y);
         }
     }
-    debug_log("SCAN_COMPLETE: %d Enemies erfolgreich initialisiert.", enemy_idx);
+#endif
+    debug_log("SCAN_COMPLETE: %d Enemies erfolgreich initialisiert.", level->enemies.count);
+}
+
+static void* level_snapshot_copy(const void* src, size_t size, bool* ok) {
+    if (!src || size == 0) return NULL;
+    void* copy = arena_alloc(&level_arena, MEM_TAG_ENEMIES, size);
+    if (copy) memcpy(copy, src, size);
+    else *ok = false;
+    return copy;
+}
+
+// Everything gameplay changes, taken once the level is fully loaded. Pointers in
+// the copied headers stay valid: the live blocks are restored in place.
+static void level_snapshot_capture(Level* level) {
+    LevelSnapshot* snap = &level->snapshot;
+    bool ok = true;
+
+    snap->enemies = level->enemies;
+    snap->enemy_block = level_snapshot_copy(level->enemies.block, level->enemies.block_size, &ok);
+    snap->grid_block = level_snapshot_copy(level->enemies.grid.cell_head, level->enemies.grid.block_size, &ok);
+    snap->projectiles = level->projectiles;
+    snap->projectile_block = level_snapshot_copy(level->projectiles.x, level->projectiles.block_size, &ok);
+    snap->player = *level->player;
+    snap->loot_chest = level->loot_chest;
+    // Item textures are shared per type and may not outlive the level, level_reset looks them up again
+    for (int i = 0; i < snap->player.inventory_count; i++) snap->player.inventory[i].texture = NULL;
+    snap->loot_chest.loot.texture = NULL;
+    snap->chest_spawned = level->chest_spawned;
+    snap->valid = ok;
+
+    size_t bytes = level->enemies.block_size + level->enemies.grid.block_size + level->projectiles.block_size;
+    if (ok) debug_log("LEVEL_SNAPSHOT: %u Bytes gesichert", (unsigned)bytes);
+    else debug_log("LEVEL_SNAPSHOT: Kein Speicher fuer %u Bytes, Reset aus den Spawn-Daten", (unsigned)bytes);
 }
 
 void level_load(Level* level, SDL_Renderer* renderer, Player* player, const char* map_path, const char** texture_paths, int tex_count, BgConfig* bg_configs) {
     if (!level || !player) return;
     level->player = player;
 
+    if (!level_arena_ready) {
+        arena_init(&level_arena, "level", LEVEL_ARENA_BLOCK_SIZE);
+        level_arena_ready = true;
+    }
+
     debug_log("DEBUG: Starte map_init...");
-    int status = map_init(&level->map, renderer, map_path, texture_paths, tex_count);
+    int status = map_init(&level->map, renderer, map_path, texture_paths, tex_count, &level_arena);
     
     if (status != 1) {
         debug_log("DEBUG: map_init fehlgeschlagen mit Status %d", status);
         return;
     }
 
-    if (level->map.tiled_map == NULL) {
-        debug_log("CRITICAL: map_init sagte 0, aber tiled_map ist NULL!");
+    if (level->map.width == 0) {
+        debug_log("CRITICAL: map_init sagte 1, aber die Map ist leer!");
         return;
     }
 
+#ifdef PERF_ENABLED
+    map_raycast_benchmark(&level->map, 100000);
+#endif
+
     debug_log("DEBUG: Starte background_layer_init...");
+    // Lowest camera of level_get_camera, the strips keep every row the parallax can reach from there
+    int max_camera_y = map_pixel_height(&level->map) - LEVEL_VIEW_H;
     // Hier crasht es oft, wenn bg_configs[0].path Müll enthält
-    level->layer_far_back = background_layer_init(renderer, bg_configs[0].path, bg_configs[0].speed, bg_configs[0].scale);
-    level->layer_mid      = background_layer_init(renderer, bg_configs[1].path, bg_configs[1].speed, bg_configs[1].scale);
+    level->layer_far_back = background_layer_init(renderer, bg_configs[0].path, bg_configs[0].speed, bg_configs[0].scale, LEVEL_VIEW_W, LEVEL_VIEW_H,
+                                                  max_camera_y);
+    level->layer_mid      = background_layer_init(renderer, bg_configs[1].path, bg_configs[1].speed, bg_configs[1].scale, LEVEL_VIEW_W, LEVEL_VIEW_H,
+                                                  max_camera_y);
 
     if (bg_configs[2].path != NULL) {
-        level->layer_fore = background_layer_init(renderer, bg_configs[2].path, bg_configs[2].speed, bg_configs[2].scale);
+        level->layer_fore = background_layer_init(renderer, bg_configs[2].path, bg_configs[2].speed, bg_configs[2].scale, LEVEL_VIEW_W, LEVEL_VIEW_H,
+                                                  max_camera_y);
     } else {
-        level->layer_fore.texture = NULL;
+        level->layer_fore = (BackgroundLayer){0};
     }
+    level->bg_far_cache = (BackgroundFarCache){0};
 
     debug_log("DEBUG: Starte level_scan_entities...");
     level_scan_entities(level, renderer);
@@ -160,9 +226,9 @@ void level_load(Level* level, SDL_Renderer* renderer, Player* player, const char
     health_potion.type = HEALTH_POTION;
     health_potion.amount = 3; // 3x healing potion in chest
     
-    level->loot_chest = chest_init(renderer, "resources/sprites/chest-", level->chest_spawn_x, level->chest_spawn_y, health_potion);
+    level->loot_chest = chest_init(renderer, "resources/sprites/chest-", level->chest_spawn_x, level->chest_spawn_y, health_potion, &level_arena);
 
-    level->txt_door_texture = IMG_LoadTexture(renderer, "resources/ui/text_door.png");
+    level->txt_door_texture = load_texture(renderer, "resources/ui/text_door.png");
     if (level->txt_door_texture) {
         SDL_QueryTexture(level->txt_door_texture, NULL, NULL, &level->txt_door_w, &level->txt_door_h);
     } else {
@@ -170,29 +236,90 @@ void level_load(Level* level, SDL_Renderer* renderer, Player* player, const char
     }
 
     // 2. Load Chest Text
-    level->txt_chest_texture = IMG_LoadTexture(renderer, "resources/ui/text_chest.png");
+    level->txt_chest_texture = load_texture(renderer, "resources/ui/text_chest.png");
     if (level->txt_chest_texture) {
         SDL_QueryTexture(level->txt_chest_texture, NULL, NULL, &level->txt_chest_w, &level->txt_chest_h);
     } else {
         debug_log("Failed to load chest text!");
     }
 
-    if (bgm_init()) {
-        bgm_play(&bgm, "resources/music/medieval-ambient-236809.wav", -1); 
+    level_snapshot_capture(level);
+    // Chunks around the spawn, before the first frame needs them
+    level_stream(level);
+
+    sfx_bank_report(map_path);
+    texture_memory_report(map_path);
+    texture_residency_report(map_path);
+    if (level->map.stream) map_stream_report(level->map.stream, map_path);
+    mem_track_report(map_path);
+}
+
+void level_get_camera(const Level* level, int* camera_x, int* camera_y) {
+    const Player* player = level->player;
+    int map_width  = map_pixel_width(&level->map);
+    int map_height = map_pixel_height(&level->map);
+
+    int x = player->entity.rect.x + (player->entity.rect.w / 2) - (LEVEL_VIEW_W / 2);
+    int y = player->entity.rect.y + (player->entity.rect.h / 2) - (LEVEL_VIEW_H / 2);
+
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x > map_width - LEVEL_VIEW_W) x = map_width - LEVEL_VIEW_W;
+    if (y > map_height - LEVEL_VIEW_H) y = map_height - LEVEL_VIEW_H;
+
+    *camera_x = x;
+    *camera_y = y;
+}
+
+void level_stream(Level* level) {
+    if (!level->map.stream) return;
+    const Entity* e = &level->player->entity;
+
+    // Everything the update touches this frame: the view plus the region where enemies still tick
+    SDL_Rect required = {0, 0, LEVEL_VIEW_W + 2 * ENEMY_EDGE_MARGIN, LEVEL_VIEW_H + 2 * ENEMY_EDGE_MARGIN};
+    level_get_camera(level, &required.x, &required.y);
+    required.x -= ENEMY_EDGE_MARGIN;
+    required.y -= ENEMY_EDGE_MARGIN;
+
+    // Plus where the player will be in LEVEL_STREAM_LOOKAHEAD frames, loaded in the background
+    SDL_Rect wanted = required;
+    int ahead_x = (int)(e->vel_x * LEVEL_STREAM_LOOKAHEAD);
+    int ahead_y = (int)(e->vel_y * LEVEL_STREAM_LOOKAHEAD);
+    wanted.w += abs(ahead_x) + LEVEL_STREAM_PAD * 2;
+    wanted.h += abs(ahead_y) + LEVEL_STREAM_PAD * 2;
+    wanted.x -= LEVEL_STREAM_PAD + (ahead_x < 0 ? -ahead_x : 0);
+    wanted.y -= LEVEL_STREAM_PAD + (ahead_y < 0 ? -ahead_y : 0);
+
+    map_stream_update(level->map.stream, &required, &wanted);
+}
+
+#if defined(PROJECTILE_BENCH_COUNT) && PROJECTILE_BENCH_COUNT > 0
+// Stress test: keeps the pool at PROJECTILE_BENCH_COUNT harmless projectiles around the view
+static void level_bench_projectiles(Level* level, const SDL_Rect* view) {
+    ProjectilePool* pool = &level->projectiles;
+    if (pool->kind_count == 0) return;
+    while (pool->count < PROJECTILE_BENCH_COUNT) {
+        float x = view->x + rand() % view->w;
+        float y = view->y + rand() % view->h;
+        float vel_x = (rand() % 2 ? 1.0f : -1.0f) * (1 + rand() % 4);
+        float vel_y = (rand() % 3 - 1) * 0.5f;
+        if (!projectile_spawn(pool, rand() % pool->kind_count, PROJECTILE_TEAM_ENEMY, -1, x, y, vel_x, vel_y, 0)) break;
     }
 }
+#endif
 
-void level_update(Level* level, SceCtrlData* pad, SDL_Renderer* renderer) {
+void level_update(Level* level, InputState* in, SDL_Renderer* renderer, const FrameClock* clock) {
     if (!level || !level->player) return;
 
     Player* player = level->player;
     int is_moving = (player->entity.vel_x != 0);
+    Uint32 now = clock->tick;
 
-    player_handle_input(player, pad);
+    player_handle_input(player, in, now);
     player_update_physics(player, &level->map);
 
-    int map_width  = level->map.tiled_map->width  * level->map.tiled_map->tilewidth;
-    int map_height = level->map.tiled_map->height * level->map.tiled_map->tileheight;
+    int map_width  = map_pixel_width(&level->map);
+    int map_height = map_pixel_height(&level->map);
 
     if (player->entity.rect.x < 0) {
         player->entity.rect.x = 0;
@@ -214,148 +341,174 @@ void level_update(Level* level, SceCtrlData* pad, SDL_Renderer* renderer) {
         player->entity.vel_y = 0;
     }
 
-    player_update_animation(player, is_moving);
-    player_update_attack(player);
-
-    for (int i = 0; i < level->enemy_count; i++) {
-        Enemy* e = level->enemies[i];
-
-        enemy_take_damage_from_player(e, player->attack_rect, 10);
-        enemy_update(e, player, &level->map);
-        enemy_handle_attack(e, player);
-
-        if (e->attack_type == RANGED) { // move projectiles of ranged enemies towards player
-            RangedEnemy* re = (RangedEnemy*)e;
-            projectiles_update(re->projectiles, player);
-        }
-    }
-
-    if (all_enemies_dead(level) && !level->chest_spawned) {
+    player_update_animation(player, is_moving, now);
+    player_update_attack(player, now);
+
+    PERF_TIMER(enemies_update_timer);
+    PERF_BEGIN(enemies_update_timer);
+    enemies_take_damage_from_player(&level->enemies, player->attack_rect, 10);
+    SDL_Rect view = {0, 0, LEVEL_VIEW_W, LEVEL_VIEW_H};
+    level_get_camera(level, &view.x, &view.y);
+    voice_set_listener(view.x + view.w / 2.0f, view.y + view.h / 2.0f);
+    enemies_update(&level->enemies, player, &level->map, &view, &level->projectiles, now);
+    PERF_END(enemies_update_timer);
+
+#if defined(PROJECTILE_BENCH_COUNT) && PROJECTILE_BENCH_COUNT > 0
+    level_bench_projectiles(level, &view);
+#endif
+    PERF_TIMER(projectiles_update_timer);
+    PERF_BEGIN(projectiles_update_timer);
+    projectiles_update(&level->projectiles, player, &level->enemies, &level->map, now);
+    PERF_END(projectiles_update_timer);
+
+    if (enemy_store_all_dead(&level->enemies) && !level->chest_spawned) {
         level->chest_spawned = true;
     }
 
     if (level->chest_spawned && !level->loot_chest.collected) {
         bool near_player = chest_check_collision(&level->loot_chest, player->entity.rect);
 
-        if (near_player && (pad->Buttons & PSP_CTRL_SQUARE)) {
+        if (near_player && input_pressed(in, PSP_CTRL_SQUARE)) {
             if (!level->loot_chest.opening) {
                 level->loot_chest.opening = true;
                 level->loot_chest.current_frame = 0;
-                level->loot_chest.last_frame_time = SDL_GetTicks();
+                level->loot_chest.last_frame_time = now;
                 add_loot_to_player(&level->loot_chest, player);
             }
         }
-        chest_update(&level->loot_chest);
+        chest_update(&level->loot_chest, now);
 
     }
+
+    voice_update(now);
 }
 
-void level_render(Level* level, SDL_Renderer* renderer, int camera_x, int camera_y) {
+void level_record(Level* level, RenderSnapshot* out, const FrameClock* clock) {
     if (!level || !level->player) return;
     Player* player = level->player;
 
-    // 1. Backgrounds
-    background_layer_render(renderer, &level->layer_far_back, camera_x, camera_y, 480, 272);
-    background_layer_render(renderer, &level->layer_mid, camera_x, camera_y, 480, 272);
-    background_layer_render(renderer, &level->layer_fore, camera_x, camera_y, 480, 272);
-
-    // 2. Map
-    map_render(renderer, &level->map, camera_x, camera_y);
+    int camera_x, camera_y;
+    level_get_camera(level, &camera_x, &camera_y);
+    render_snapshot_begin(out, camera_x, camera_y, clock->tick);
+    out->game_over = false;
 
-    // 3. Enemies
-    for(int i = 0; i < level->enemy_count; i++) {
-        enemy_render(renderer, level->enemies[i], camera_x, camera_y);
+    // 1. Enemies
+    render_snapshot_subsystem(out, RENDER_SUB_ENEMIES);
+    enemies_render(out, &level->enemies, camera_x, camera_y, clock->tick);
 
-        if (level->enemies[i]->attack_type == RANGED) { // render proctiles of ranged enemies
-        RangedEnemy* re = (RangedEnemy*)level->enemies[i];
-        projectiles_render(renderer, re->projectiles, camera_x, camera_y);
-    }
-    }
+    PERF_TIMER(projectiles_render_timer);
+    PERF_BEGIN(projectiles_render_timer);
+    render_snapshot_subsystem(out, RENDER_SUB_PROJECTILES);
+    projectiles_render(out, &level->projectiles, camera_x, camera_y, LEVEL_VIEW_W, LEVEL_VIEW_H, clock->tick);
+    PERF_END(projectiles_render_timer);
 
-    // 4. Player
+    // 2. Player
     int is_moving = (player->entity.vel_x != 0);
-    player_render(renderer, player, is_moving, camera_x, camera_y);
+    render_snapshot_subsystem(out, RENDER_SUB_PLAYER);
+    player_render(out, player, is_moving, camera_x, camera_y, clock->tick);
 
-    // 5. Chest & Interaction UI
+    // 3. Chest & Interaction UI
+    render_snapshot_subsystem(out, RENDER_SUB_INTERACTABLES);
     if (level->chest_spawned && !level->loot_chest.collected) {
-        chest_render(renderer, &level->loot_chest, camera_x, camera_y);
+        chest_render(out, &level->loot_chest, camera_x, camera_y);
 
         if (chest_check_collision(&level->loot_chest, player->entity.rect)) {
-            // Check if texture exists before drawing
-            if (level->txt_chest_texture) {
-                // Center text above chest
-                int visual_chest_w = level->loot_chest.rect.w * 1.5;
-                int text_x = (level->loot_chest.rect.x - camera_x) + (visual_chest_w / 2) - (level->txt_chest_w / 2);
-                int text_y = (level->loot_chest.rect.y - camera_y) - level->txt_chest_h - 5;
-
-                SDL_Rect dst = { text_x, text_y, level->txt_chest_w, level->txt_chest_h };
-                SDL_RenderCopy(renderer, level->txt_chest_texture, NULL, &dst);
-            }
+            // Center text above chest
+            int visual_chest_w = level->loot_chest.rect.w * 1.5;
+            int text_x = (level->loot_chest.rect.x - camera_x) + (visual_chest_w / 2) - (level->txt_chest_w / 2);
+            int text_y = (level->loot_chest.rect.y - camera_y) - level->txt_chest_h - 5;
+
+            SDL_Rect dst = { text_x, text_y, level->txt_chest_w, level->txt_chest_h };
+            render_snapshot_sprite(out, level->txt_chest_texture, &dst, SDL_FLIP_NONE);
         }
     }
 
-    // 6. UI 
-    ui_render_health_bar(renderer, player->entity.health);
-    ui_render_inventory(renderer, player->inventory, player->inventory_count);
-
-// 7. Door Indicator
+    // 4. Door Indicator
     int check_x = player->entity.rect.x + (player->entity.rect.w / 2);
     int check_y = player->entity.rect.y + player->entity.rect.h - 8;
 
     if (map_get_shape_at(&level->map, check_x, check_y) == SHAPE_DOOR) {
-        if (level->txt_door_texture) {
-            SDL_Rect dst = {
-                    (player->entity.rect.x - camera_x) - 20,
-                    (player->entity.rect.y - camera_y) - 30,
-                    level->txt_door_w, level->txt_door_h
-            };
-            SDL_RenderCopy(renderer, level->txt_door_texture, NULL, &dst);
-        }
+        SDL_Rect dst = {
+                (player->entity.rect.x - camera_x) - 20,
+                (player->entity.rect.y - camera_y) - 30,
+                level->txt_door_w, level->txt_door_h
+        };
+        render_snapshot_sprite(out, level->txt_door_texture, &dst, SDL_FLIP_NONE);
     }
+
+    // 5. HUD values, drawn on top of everything by level_render
+    out->hud_dirty = ui_take_hud_dirty();
+    out->health = player->entity.health;
+    out->inventory_count = player->inventory_count;
+    memcpy(out->inventory, player->inventory, sizeof(out->inventory));
+}
+
+void level_render(Level* level, SDL_Renderer* renderer, const RenderSnapshot* snap) {
+    if (!level || !snap->valid) return;
+
+    // 1. Backgrounds
+    BackgroundLayer *layers[] = { &level->layer_far_back, &level->layer_mid, &level->layer_fore };
+    level->bg_far_cache.half_rate = quality_at_least(QUALITY_FAR_HALF_RATE);
+    // Only where no opaque tile covers them, the map is drawn on top anyway
+    SDL_Rect uncovered[LEVEL_BG_CLIP_RECTS];
+    BackgroundClip clip = { uncovered, map_uncovered_rects(&level->map, snap->camera_x, snap->camera_y, LEVEL_VIEW_W, LEVEL_VIEW_H, uncovered, LEVEL_BG_CLIP_RECTS) };
+    if (clip.count < 0) clip.rects = NULL;
+    background_render(renderer, &level->bg_far_cache, layers, 3, snap->camera_x, snap->camera_y, LEVEL_VIEW_W, LEVEL_VIEW_H, &clip);
+
+    // 2. Map
+    map_render(renderer, &level->map, snap->camera_x, snap->camera_y);
+
+    // 3. Enemies, projectiles, player, chest and hints as recorded by the update
+    render_snapshot_submit(renderer, snap);
+
+    // 4. UI
+    ui_render_hud(renderer, snap);
 }
 
 void level_reset(Level* level) {
     if (!level || !level->player) return;
-    Player* player = level->player;
+    const LevelSnapshot* snap = &level->snapshot;
 
-    player->entity.rect.x = 50;
-    player->entity.rect.y = 20;
-    player->entity.health = PLAYER_MAX_HEALTH;
-    player->entity.vel_x = 0;
-    player->entity.vel_y = 0;
-
-    for (int i = 0; i < level->enemy_count; i++) {
-        level->enemies[i]->entity.health = level->enemies[i]->max_health;
-        level->enemies[i]->entity.rect.x = level->enemies[i]->spawn_x;
-        level->enemies[i]->entity.rect.y = level->enemies[i]->spawn_y;
-        level->enemies[i]->is_moving = 0;
-        level->enemies[i]->entity.vel_x = 0;
-        level->enemies[i]->entity.vel_y = 0;
+    // Grunts and shots of the old run would keep playing on stale handles
+    voice_stop_all();
+
+    if (snap->valid) {
+        level->enemies = snap->enemies;
+        level->projectiles = snap->projectiles;
+        if (snap->enemy_block) memcpy(level->enemies.block, snap->enemy_block, level->enemies.block_size);
+        if (snap->grid_block) memcpy(level->enemies.grid.cell_head, snap->grid_block, level->enemies.grid.block_size);
+        if (snap->projectile_block) memcpy(level->projectiles.x, snap->projectile_block, level->projectiles.block_size);
+    } else {
+        enemy_store_reset(&level->enemies);
+        projectile_pool_clear(&level->projectiles, &level->enemies);
     }
+    *level->player = snap->player;
+    level->loot_chest = snap->loot_chest;
+    for (int i = 0; i < level->player->inventory_count; i++) {
+        Item* item = &level->player->inventory[i];
+        item->texture = item_texture(item->type);
+    }
+    level->loot_chest.loot.texture = item_texture(level->loot_chest.loot.type);
+    level->chest_spawned = snap->chest_spawned;
+
+    // A restart always starts with full health, even if the level was entered hurt
+    level->player->entity.health = PLAYER_MAX_HEALTH;
+    ui_mark_hud_dirty();
 }
 
 void level_cleanup(Level* level) {
     if (!level) return;
 
-    bgm_cleanup(&bgm);
-
-    for(int i = 0; i < level->enemy_count; i++) {
-        if (level->enemies[i]->attack_type == RANGED) {
-            projectile_sprite_cleanup((RangedEnemy*)level->enemies[i]);
-        }
-        free(level->enemies[i]);
-        level->enemies[i] = NULL;
-    }
-    free(level->enemies);
-    level->enemies = NULL;
-
+    projectile_pool_cleanup(&level->projectiles);
+    enemy_store_cleanup(&level->enemies);
+    chest_cleanup(&level->loot_chest);
 
     if (level->txt_door_texture) {
-        SDL_DestroyTexture(level->txt_door_texture);
+        mem_track_texture_destroy(level->txt_door_texture);
         level->txt_door_texture = NULL;
     }
     if (level->txt_chest_texture) {
-        SDL_DestroyTexture(level->txt_chest_texture);
+        mem_track_texture_destroy(level->txt_chest_texture);
         level->txt_chest_texture = NULL;
     }
 
@@ -364,4 +517,14 @@ void level_cleanup(Level* level) {
     background_layer_cleanup(&level->layer_far_back);
     background_layer_cleanup(&level->layer_mid);
     background_layer_cleanup(&level->layer_fore);
+    background_far_cache_cleanup(&level->bg_far_cache);
+
+    // Textures are gone, everything else of the level goes in one step
+    if (level_arena_ready) arena_reset(&level_arena);
+}
+
+void level_arena_shutdown(void) {
+    if (!level_arena_ready) return;
+    arena_destroy(&level_arena);
+    level_arena_ready = false;
 }
\ No newline at end of file
@@ -9,16 +9,39 @@
 #include "../enemies/enemy.h"
 #include "../interactables/chest.h"
 #include "../background/background.h"
+#include "../clock/frameClock.h"
+
+struct RenderSnapshot;
+
+// Visible area in pixels (PSP screen)
+#define LEVEL_VIEW_W 480
+#define LEVEL_VIEW_H 272
+// Uncovered screen areas the backgrounds are clipped to, more and they are drawn whole
+#define LEVEL_BG_CLIP_RECTS 48
+
+// Mutable level state right after level_load; level_reset copies it back
+typedef struct {
+    bool valid;
+    EnemyStore enemies;        // header: arrays and grid point into the live blocks
+    void* enemy_block;
+    void* grid_block;
+    ProjectilePool projectiles;
+    void* projectile_block;
+    Player player;
+    Chest loot_chest;
+    bool chest_spawned;
+} LevelSnapshot;
 
 typedef struct Level {
     Map map;
     BackgroundLayer layer_far_back;
     BackgroundLayer layer_mid;
     BackgroundLayer layer_fore;
+    BackgroundFarCache bg_far_cache;
 
     Player* player;
-    Enemy** enemies;
-    int enemy_count;
+    EnemyStore enemies;
+    ProjectilePool projectiles;
 
     Chest loot_chest;
     bool chest_spawned;
@@ -31,6 +54,8 @@ typedef struct Level {
 
     int chest_spawn_x;
     int chest_spawn_y;
+
+    LevelSnapshot snapshot;
 } Level;
 
 typedef struct {
@@ -41,9 +66,19 @@ typedef struct {
 
 void level_load(Level* level, SDL_Renderer* renderer, Player* player, const char* map_path, const char** texture_paths, int tex_count, BgConfig* bg_configs);
 void level_scan_entities(Level* level, SDL_Renderer* renderer);
-void level_update(Level* level, SceCtrlData* pad, SDL_Renderer* renderer);
-void level_render(Level* level, SDL_Renderer* renderer, int camera_x, int camera_y);
+void level_update(Level* level, InputState* in, SDL_Renderer* renderer, const FrameClock* clock);
+// Camera centered on the player, clamped to the map
+void level_get_camera(const Level* level, int* camera_x, int* camera_y);
+// Streamed maps: loads / queues the chunks around the camera. Main thread, update idle
+void level_stream(Level* level);
+// Records the drawables of the current state into out (runs with the update)
+void level_record(Level* level, struct RenderSnapshot* out, const FrameClock* clock);
+// Draws backgrounds and map at the snapshot camera, then the snapshot itself and the HUD
+void level_render(Level* level, SDL_Renderer* renderer, const struct RenderSnapshot* snap);
+// Restores the snapshot taken by level_load (restart after game over)
 void level_reset(Level* level);
 void level_cleanup(Level* level);
+// Returns the level arena blocks to the heap, call once on shutdown
+void level_arena_shutdown(void);
 
 #endif
\ No newline at end of file
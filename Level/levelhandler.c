@@ -1,8 +1,16 @@
 #include "levelHandler.h"
 #include <stdio.h>
+#include "../bgm/bgmHandler.h"
+#include "../enemies/enemyArchetype.h"
+#include "../render/renderSnapshot.h"
+#include "../ui/ui.h"
 
 extern void debug_log(const char *format, ...);
 
+// Music outlives single levels; static because the loader thread writes into it
+// while LevelHandler itself is passed around by value
+static BGMHandler bgm;
+
 // Store texture configs for each level
 const char* level1_textures[] = {
         "resources/levels/cemetery/tileset.png",
@@ -37,11 +45,17 @@ LevelHandler level_handler_init(SDL_Renderer* renderer, Player* player) {
     handler.map_paths[0] = "resources/maps/map_level1.json";
     handler.map_paths[1] = "resources/maps/map_level2.json";
 
+    handler.music_paths[0] = "resources/music/medieval-ambient-236809.ogg";
+    handler.music_paths[1] = "resources/music/medieval-ambient-236809.ogg";
+
+    bgm_init();
+
     debug_log("Handler: Loading Level 0...");
     level_load(&handler.current_level, renderer, player,
                handler.map_paths[0],
                level1_textures, 2,
                level1_bgs);
+    bgm_play(&bgm, handler.music_paths[0], -1);
 
     return handler;
 }
@@ -67,17 +81,20 @@ void level_handler_change_level(LevelHandler* handler, int new_index) {
                    level2_bgs);
     }
 
+    // Same track keeps streaming, a different one is preloaded and faded in
+    bgm_play(&bgm, handler->music_paths[new_index], -1);
+
     // Reset Player Velocity
     handler->player->entity.vel_x = 0;
     handler->player->entity.vel_y = 0;
 }
 
-void level_handler_update(LevelHandler* handler, SceCtrlData* pad) {
+void level_handler_update(LevelHandler* handler, InputState* in, const FrameClock* clock) {
     Level* lvl = &handler->current_level;
     Player* p = handler->player;
 
     // 1. Update the actual level logic
-    level_update(lvl, pad, handler->renderer);
+    level_update(lvl, in, handler->renderer, clock);
 
     // 2. Check for Door Interaction
     // We check slightly above the player's feet for a Door Tile
@@ -87,17 +104,42 @@ void level_handler_update(LevelHandler* handler, SceCtrlData* pad) {
     int shape = map_get_shape_at(&lvl->map, check_x, check_y);
 
     if (shape == SHAPE_DOOR) {
-        // If Player presses UP (or whatever interact button)
-        if (pad->Buttons & PSP_CTRL_UP) {
-            level_handler_change_level(handler, handler->current_level_index + 1);
+        // If Player presses UP (or whatever interact button), once per press
+        if (input_pressed(in, PSP_CTRL_UP)) {
+            level_handler_request_level(handler, handler->current_level_index + 1);
         }
     }
 }
 
-void level_handler_render(LevelHandler* handler, int camera_x, int camera_y) {
-    level_render(&handler->current_level, handler->renderer, camera_x, camera_y);
+void level_handler_record(LevelHandler* handler, RenderSnapshot* out, const FrameClock* clock) {
+    level_record(&handler->current_level, out, clock);
+}
+
+void level_handler_request_level(LevelHandler* handler, int new_index) {
+    if (new_index >= handler->total_levels) return;
+    handler->transition_pending = true;
+    handler->pending_level_index = new_index;
+}
+
+bool level_handler_sync(LevelHandler* handler) {
+    bgm_update(&bgm);
+    level_stream(&handler->current_level);
+    if (!handler->transition_pending) return false;
+
+    handler->transition_pending = false;
+    level_handler_change_level(handler, handler->pending_level_index);
+    // The snapshot that carried the last dirty flag is dropped with the old level
+    ui_mark_hud_dirty();
+    return true;
+}
+
+void level_handler_render(LevelHandler* handler, const RenderSnapshot* snap) {
+    level_render(&handler->current_level, handler->renderer, snap);
 }
 
 void level_handler_cleanup(LevelHandler* handler) {
     level_cleanup(&handler->current_level);
+    enemy_archetypes_cleanup();
+    bgm_cleanup(&bgm);
+    level_arena_shutdown();
 }
\ No newline at end of file
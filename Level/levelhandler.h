@@ -2,7 +2,6 @@
 #define LEVEL_HANDLER_H
 
 #include <SDL.h>
-#include <pspctrl.h>
 #include "level.h"
 #include "../player/player.h"
 
@@ -15,17 +14,26 @@ typedef struct {
 
     // Config: Array of map paths
     const char* map_paths[MAX_LEVELS];
+    const char* music_paths[MAX_LEVELS];
 
     // Dependencies
     SDL_Renderer* renderer;
     Player* player;
 
+    // Level switches load textures, so the update only requests them
+    // and level_handler_sync performs them on the main thread
     bool transition_pending;
+    int pending_level_index;
 } LevelHandler;
 
 LevelHandler level_handler_init(SDL_Renderer* renderer, Player* player);
-void level_handler_update(LevelHandler* handler, SceCtrlData* pad);
-void level_handler_render(LevelHandler* handler, int camera_x, int camera_y);
+// Simulation side (update thread): must not touch the renderer
+void level_handler_update(LevelHandler* handler, InputState* in, const FrameClock* clock);
+void level_handler_record(LevelHandler* handler, struct RenderSnapshot* out, const FrameClock* clock);
+void level_handler_request_level(LevelHandler* handler, int new_index);
+// Main thread, while the update is idle: music and pending level switch. True if the level changed
+bool level_handler_sync(LevelHandler* handler);
+void level_handler_render(LevelHandler* handler, const struct RenderSnapshot* snap);
 void level_handler_cleanup(LevelHandler* handler);
 void level_handler_change_level(LevelHandler* handler, int new_index);
 
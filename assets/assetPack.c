@@ -0,0 +1,205 @@
+#include "assetPack.h"
+#include "../memory/memTrack.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+extern void debug_log(const char *format, ...);
+
+typedef struct {
+    Uint32 name_offset;
+    Uint32 offset;
+    Uint32 size;
+    Uint32 stored_size;   // == size: stored, otherwise zlib
+} AssetEntry;
+
+// One open entry: a window into the pack file, or the inflated copy for deflated entries
+typedef struct {
+    Uint32 base;
+    Uint32 size;
+    Uint32 pos;
+    Uint8* data;
+} AssetStream;
+
+static SDL_RWops* g_pack = NULL;
+static SDL_mutex* g_pack_lock = NULL;   // the music loader thread reads as well
+static Sint64 g_pack_pos = -1;          // skip the seek when reads continue where the last one stopped
+static AssetEntry* g_entries = NULL;    // sorted by name
+static const char* g_names = NULL;
+static int g_entry_count = 0;
+
+bool asset_pack_init(const char* pack_path) {
+    if (g_pack) return true;
+
+    SDL_RWops* rw = SDL_RWFromFile(pack_path, "rb");
+    if (!rw) {
+        debug_log("ASSET_PACK: %s nicht gefunden, lade lose Dateien", pack_path);
+        return false;
+    }
+
+    char magic[4];
+    if (SDL_RWread(rw, magic, 1, 4) != 4 || memcmp(magic, ASSET_PACK_MAGIC, 4) != 0
+        || SDL_ReadLE32(rw) != ASSET_PACK_VERSION) {
+        debug_log("ASSET_PACK: %s ist kein gueltiges Pack", pack_path);
+        SDL_RWclose(rw);
+        return false;
+    }
+    int count = (int)SDL_ReadLE32(rw);
+    Uint32 names_size = SDL_ReadLE32(rw);
+
+    // TOC and names in one block, read with two calls
+    size_t toc_bytes = (size_t)count * sizeof(AssetEntry);
+    Uint8* block = mem_alloc(MEM_TAG_ASSETS, toc_bytes + names_size);
+    if (!block || SDL_RWread(rw, block, 1, toc_bytes + names_size) != toc_bytes + names_size) {
+        debug_log("ASSET_PACK: TOC von %s unvollstaendig", pack_path);
+        mem_free(block);
+        SDL_RWclose(rw);
+        return false;
+    }
+
+    g_entries = (AssetEntry*)block;
+    for (int i = 0; i < count; i++) {
+        g_entries[i].name_offset = SDL_SwapLE32(g_entries[i].name_offset);
+        g_entries[i].offset = SDL_SwapLE32(g_entries[i].offset);
+        g_entries[i].size = SDL_SwapLE32(g_entries[i].size);
+        g_entries[i].stored_size = SDL_SwapLE32(g_entries[i].stored_size);
+    }
+    g_names = (const char*)(block + toc_bytes);
+    g_entry_count = count;
+    g_pack = rw;
+    g_pack_pos = -1;
+    g_pack_lock = SDL_CreateMutex();
+    debug_log("ASSET_PACK: %s mit %d Eintraegen geladen", pack_path, count);
+    return true;
+}
+
+static const AssetEntry* asset_find(const char* path) {
+    int lo = 0, hi = g_entry_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(path, g_names + g_entries[mid].name_offset);
+        if (cmp == 0) return &g_entries[mid];
+        if (cmp < 0) hi = mid - 1;
+        else lo = mid + 1;
+    }
+    return NULL;
+}
+
+bool asset_exists(const char* path) {
+    if (!path) return false;
+    if (g_pack) return asset_find(path) != NULL;
+    return access(path, F_OK) != -1;
+}
+
+static size_t asset_pack_read_at(Uint32 offset, void* dst, size_t bytes) {
+    SDL_LockMutex(g_pack_lock);
+    if (g_pack_pos != offset) SDL_RWseek(g_pack, offset, RW_SEEK_SET);
+    size_t got = SDL_RWread(g_pack, dst, 1, bytes);
+    g_pack_pos = offset + got;
+    SDL_UnlockMutex(g_pack_lock);
+    return got;
+}
+
+// --- SDL_RWops over an entry ---
+
+static Sint64 asset_stream_size(SDL_RWops* rw) {
+    return ((AssetStream*)rw->hidden.unknown.data1)->size;
+}
+
+static Sint64 asset_stream_seek(SDL_RWops* rw, Sint64 offset, int whence) {
+    AssetStream* s = rw->hidden.unknown.data1;
+    Sint64 pos = offset;
+    if (whence == RW_SEEK_CUR) pos += s->pos;
+    else if (whence == RW_SEEK_END) pos += s->size;
+    if (pos < 0) pos = 0;
+    if (pos > s->size) pos = s->size;
+    s->pos = (Uint32)pos;
+    return pos;
+}
+
+static size_t asset_stream_read(SDL_RWops* rw, void* ptr, size_t size, size_t maxnum) {
+    AssetStream* s = rw->hidden.unknown.data1;
+    if (size == 0) return 0;
+    size_t avail = (s->size - s->pos) / size;
+    size_t num = maxnum < avail ? maxnum : avail;
+    size_t bytes = num * size;
+    if (bytes == 0) return 0;
+
+    if (s->data) memcpy(ptr, s->data + s->pos, bytes);
+    else bytes = asset_pack_read_at(s->base + s->pos, ptr, bytes);
+    s->pos += (Uint32)bytes;
+    return bytes / size;
+}
+
+static size_t asset_stream_write(SDL_RWops* rw, const void* ptr, size_t size, size_t num) {
+    return 0;   // read only
+}
+
+static int asset_stream_close(SDL_RWops* rw) {
+    AssetStream* s = rw->hidden.unknown.data1;
+    mem_free(s->data);
+    mem_free(s);
+    SDL_FreeRW(rw);
+    return 0;
+}
+
+static Uint8* asset_inflate(const AssetEntry* entry) {
+    Uint8* packed = mem_alloc(MEM_TAG_ASSETS, entry->stored_size);
+    Uint8* data = mem_alloc(MEM_TAG_ASSETS, entry->size);
+    uLongf out_size = entry->size;
+    if (!packed || !data
+        || asset_pack_read_at(entry->offset, packed, entry->stored_size) != entry->stored_size
+        || uncompress(data, &out_size, packed, entry->stored_size) != Z_OK || out_size != entry->size) {
+        mem_free(data);
+        data = NULL;
+    }
+    mem_free(packed);
+    return data;
+}
+
+SDL_RWops* asset_open(const char* path) {
+    if (!path) return NULL;
+
+    const AssetEntry* entry = g_pack ? asset_find(path) : NULL;
+    if (!entry) return SDL_RWFromFile(path, "rb");
+
+    AssetStream* s = mem_calloc(MEM_TAG_ASSETS, 1, sizeof(AssetStream));
+    SDL_RWops* rw = s ? SDL_AllocRW() : NULL;
+    if (!rw) {
+        mem_free(s);
+        return NULL;
+    }
+    s->base = entry->offset;
+    s->size = entry->size;
+    if (entry->stored_size != entry->size) {
+        s->data = asset_inflate(entry);
+        if (!s->data) {
+            debug_log("ASSET_PACK: %s konnte nicht entpackt werden", path);
+            mem_free(s);
+            SDL_FreeRW(rw);
+            return NULL;
+        }
+    }
+
+    rw->size = asset_stream_size;
+    rw->seek = asset_stream_seek;
+    rw->read = asset_stream_read;
+    rw->write = asset_stream_write;
+    rw->close = asset_stream_close;
+    rw->type = SDL_RWOPS_UNKNOWN;
+    rw->hidden.unknown.data1 = s;
+    return rw;
+}
+
+void asset_pack_cleanup(void) {
+    if (!g_pack) return;
+    SDL_RWclose(g_pack);
+    SDL_DestroyMutex(g_pack_lock);
+    mem_free(g_entries);
+    g_pack = NULL;
+    g_pack_lock = NULL;
+    g_entries = NULL;
+    g_names = NULL;
+    g_entry_count = 0;
+}
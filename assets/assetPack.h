@@ -0,0 +1,21 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+// Built by tools/build_pack.py next to the EBOOT
+#define ASSET_PACK_PATH "resources.pak"
+#define ASSET_PACK_MAGIC "RPAK"
+#define ASSET_PACK_VERSION 1
+
+// Loads the table of contents; without a pack every asset_open falls back to loose files
+bool asset_pack_init(const char* pack_path);
+// Entry from the pack, or the loose file if the path is not packed. Close with SDL_RWclose
+// (or pass freesrc = 1 to the *_RW loaders). Safe to call from the music loader thread.
+SDL_RWops* asset_open(const char* path);
+// Table of contents lookup, no file access; the loose file is only checked when there is no pack
+bool asset_exists(const char* path);
+void asset_pack_cleanup(void);
+
+#endif
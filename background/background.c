@@ -1,78 +1,255 @@
 // background.c
 #include "background.h"
+#include "../texture/textureFormat.h"
+#include "../assets/assetPack.h"
+#include "../render/renderStats.h"
+#include "../memory/memTrack.h"
+#include "../debug/perf.h"
 #include <SDL_image.h>
 
-extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
+// Vertical parallax moves by camera_y * speed * 0.1; rows below the screen plus the largest offset are never visible
+#define BG_VERTICAL_SPEED_FACTOR 0.1f
+
 extern void debug_log(const char *format, ...);
 
-BackgroundLayer background_layer_init(SDL_Renderer *renderer, const char *path, float speed, float scale) {
+// Fill rate of the backgrounds: pixels copied, and what the same frames cost without clipping
+typedef struct {
+    Uint64 drawn;
+    Uint64 unclipped;
+    Uint32 frames;
+} BackgroundPixels;
+
+static BackgroundPixels g_pixels;
+
+BackgroundLayer background_layer_init(SDL_Renderer *renderer, const char *path, float speed, float scale, int screen_width, int screen_height,
+                                      int max_camera_y) {
     BackgroundLayer layer = {0};
-    layer.texture = load_texture(renderer, path);
+    layer.scroll_speed = speed;
+    layer.scale = scale > 0.0f ? scale : 1.0f;
 
+    SDL_Surface *raw = IMG_Load_RW(asset_open(path), 1);
+    if (!raw) {
+        debug_log("BG_ERROR: Konnte Textur nicht laden: %s (%s)", path, IMG_GetError());
+        return layer;
+    }
+
+    // --- 1. Pre-scale once at load instead of every frame ---
+    SDL_Surface *src = SDL_ConvertSurfaceFormat(raw, SDL_PIXELFORMAT_RGBA8888, 0);
+    SDL_FreeSurface(raw);
+    if (!src) {
+        debug_log("BG_ERROR: Konvertierung fehlgeschlagen: %s", SDL_GetError());
+        return layer;
+    }
+
+    int w = (int)(src->w * layer.scale);
+    int h = (int)(src->h * layer.scale);
+    if (w <= 0 || h <= 0) {
+        SDL_FreeSurface(src);
+        return layer;
+    }
+
+    // --- 2. Repeat horizontally until one strip covers the screen, so a frame needs at most 2 copies ---
+    int repeats = (screen_width + w - 1) / w;
+    if (repeats < 1) repeats = 1;
+    layer.tile_w = w;
+    layer.strip_w = w * repeats;
+    layer.strip_h = h;
+    // Same rounding as background_layer_offsets, so the deepest camera still finds its rows
+    int max_offset_y = (int)(SDL_max(max_camera_y, 0) * speed * BG_VERTICAL_SPEED_FACTOR);
+    if (layer.strip_h > screen_height + max_offset_y) layer.strip_h = screen_height + max_offset_y;
+
+    SDL_Surface *strip = SDL_CreateRGBSurfaceWithFormat(0, layer.strip_w, layer.strip_h, 32, SDL_PIXELFORMAT_RGBA8888);
+    if (!strip) {
+        debug_log("BG_ERROR: Strip-Surface fehlgeschlagen: %s", SDL_GetError());
+        SDL_FreeSurface(src);
+        return layer;
+    }
+    SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+    for (int i = 0; i < repeats; i++) {
+        SDL_Rect dst = { i * w, 0, w, h };
+        SDL_BlitScaled(src, NULL, strip, &dst);
+    }
+
+    layer.texture = texture_create_from_surface(renderer, strip, path);
     if (!layer.texture) {
-        debug_log("BG_ERROR: Konnte Textur nicht laden: %s", path);
+        debug_log("BG_ERROR: Texture Creation failed: %s", SDL_GetError());
     } else {
-        int w, h;
-        SDL_QueryTexture(layer.texture, NULL, NULL, &w, &h);
-        debug_log("BG_SUCCESS: Layer geladen [%s]. Original: %dx%d, Speed: %.2f, Scale: %.2f", 
-                  path, w, h, speed, scale);
+        SDL_SetTextureBlendMode(layer.texture, SDL_BLENDMODE_BLEND);
+        debug_log("BG_SUCCESS: Layer geladen [%s]. Original: %dx%d, Strip: %dx%d, Speed: %.2f, Scale: %.2f",
+                  path, src->w, src->h, layer.strip_w, layer.strip_h, speed, scale);
     }
 
-    layer.scroll_speed = speed;
-    layer.scale = scale > 0.0f ? scale : 1.0f;
+    SDL_FreeSurface(strip);
+    SDL_FreeSurface(src);
     return layer;
 }
 
-void background_layer_render(SDL_Renderer *renderer, const BackgroundLayer *layer, int camera_x, int camera_y, int screen_width, int screen_height) {
-    if (!layer->texture) return;
+static void background_layer_offsets(const BackgroundLayer *layer, int camera_x, int camera_y, int *offset_x, int *offset_y) {
+    // Wrap using the scaled image width
+    int ox = (int)((float)camera_x * layer->scroll_speed) % layer->tile_w;
+    if (ox < 0) ox += layer->tile_w;
+    *offset_x = ox;
+    *offset_y = (int)(camera_y * layer->scroll_speed * BG_VERTICAL_SPEED_FACTOR);
+}
 
-    int raw_w, raw_h;
-    SDL_QueryTexture(layer->texture, NULL, NULL, &raw_w, &raw_h);
+// Copies the texture 1:1 to dst (src_x, src_y = texel at its top left corner), only the parts inside the clip rects
+static void background_copy(SDL_Renderer *renderer, SDL_Texture *texture, int src_x, int src_y, const SDL_Rect *dst,
+                            const SDL_Rect *screen, const BackgroundClip *clip) {
+    SDL_Rect visible;
+    if (!SDL_IntersectRect(dst, screen, &visible)) return;
+    g_pixels.unclipped += (Uint64)visible.w * visible.h;
+
+    if (!clip || !clip->rects) {
+        SDL_Rect src = { src_x + visible.x - dst->x, src_y + visible.y - dst->y, visible.w, visible.h };
+        render_copy(renderer, RENDER_SUB_BACKGROUND, texture, &src, &visible);
+        g_pixels.drawn += (Uint64)visible.w * visible.h;
+        return;
+    }
+    for (int i = 0; i < clip->count; i++) {
+        SDL_Rect part;
+        if (!SDL_IntersectRect(&visible, &clip->rects[i], &part)) continue;
+        SDL_Rect src = { src_x + part.x - dst->x, src_y + part.y - dst->y, part.w, part.h };
+        render_copy(renderer, RENDER_SUB_BACKGROUND, texture, &src, &part);
+        g_pixels.drawn += (Uint64)part.w * part.h;
+    }
+}
+
+static void background_layer_draw(SDL_Renderer *renderer, const BackgroundLayer *layer, int offset_x, int offset_y,
+                                  int screen_width, int screen_height, const BackgroundClip *clip) {
+    // Strip is at least screen_width wide: one copy from offset_x to its end, one wrapped copy for the rest
+    SDL_Rect screen = { 0, 0, screen_width, screen_height };
+    int first_w = layer->strip_w - offset_x;
+    if (first_w > screen_width) first_w = screen_width;
+
+    SDL_Rect dst = { 0, -offset_y, first_w, layer->strip_h };
+    background_copy(renderer, layer->texture, offset_x, 0, &dst, &screen, clip);
 
-    if (raw_w <= 0) return;
+    if (first_w < screen_width) {
+        SDL_Rect dst2 = { first_w, -offset_y, screen_width - first_w, layer->strip_h };
+        background_copy(renderer, layer->texture, 0, 0, &dst2, &screen, clip);
+    }
+}
 
-    // --- 2. Calculate Scaled Dimensions ---
-    int w = (int)(raw_w * layer->scale);
-    int h = (int)(raw_h * layer->scale);
+void background_layer_render(SDL_Renderer *renderer, const BackgroundLayer *layer, int camera_x, int camera_y, int screen_width, int screen_height,
+                             const BackgroundClip *clip) {
+    if (!layer->texture || layer->tile_w <= 0) return;
 
-    // --- 3. Update Parallax with Scaled Width ---
-    float parallax_x = (float)camera_x * layer->scroll_speed;
+    int offset_x, offset_y;
+    background_layer_offsets(layer, camera_x, camera_y, &offset_x, &offset_y);
+
+    // Every 300th call, no clock needed for a throttled debug line
+    static int bg_debug_calls = 0;
+    if (bg_debug_calls++ % 300 == 0) {
+        debug_log("BG_RENDER: Drawing at OffsetX: %d, OffsetY: %d, ScaledW: %d", offset_x, offset_y, layer->tile_w);
+    }
+
+    background_layer_draw(renderer, layer, offset_x, offset_y, screen_width, screen_height, clip);
+}
 
-    // Wrap using the SCALED width
-    int offset_x = (int)parallax_x % w;
-    if (offset_x < 0) offset_x += w;
+static bool background_far_cache_prepare(SDL_Renderer *renderer, BackgroundFarCache *cache, BackgroundLayer *layers[], int count, int screen_width, int screen_height) {
+    if (cache->texture) return true;
+    if (cache->target_failed) return false;
 
-    float vertical_speed_factor = 0.1f;
-    int offset_y = (int)(camera_y * layer->scroll_speed * vertical_speed_factor);
+    int h = 0;
+    for (int i = 0; i < count; i++) {
+        if (layers[i]->strip_h > h) h = layers[i]->strip_h;
+    }
+    if (h > screen_height) h = screen_height;
+    if (h <= 0) return false;
+
+    cache->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, screen_width, h);
+    if (!cache->texture) {
+        debug_log("BG_WARN: Far-Cache nicht verfuegbar (%s), zeichne direkt.", SDL_GetError());
+        cache->target_failed = true;
+        return false;
+    }
+    SDL_SetTextureBlendMode(cache->texture, SDL_BLENDMODE_BLEND);
+    mem_track_texture_created(cache->texture);
+    cache->w = screen_width;
+    cache->h = h;
+    cache->valid = false;
+    return true;
+}
 
-    static Uint32 last_bg_debug = 0;
-    if (SDL_GetTicks() - last_bg_debug > 5000) {
-        debug_log("BG_RENDER: Drawing at OffsetX: %d, OffsetY: %d, ScaledW: %d", offset_x, offset_y, w);
-        last_bg_debug = SDL_GetTicks();
+void background_render(SDL_Renderer *renderer, BackgroundFarCache *cache, BackgroundLayer *layers[], int count, int camera_x, int camera_y,
+                       int screen_width, int screen_height, const BackgroundClip *clip) {
+    // 1. Collect the leading far layers
+    int far_count = 0;
+    while (far_count < count && far_count < BG_MAX_FAR_LAYERS &&
+           layers[far_count]->texture && layers[far_count]->scroll_speed <= BG_FAR_SPEED_MAX) {
+        far_count++;
     }
-    
-    // --- 4. Render Loop with Scaled Rects ---
-    int current_draw_x = -offset_x;
 
-    while (current_draw_x < screen_width) {
-        SDL_Rect dest_rect = {
-                current_draw_x,
-                -offset_y,
-                w, // Render with scaled width
-                h  // Render with scaled height
-        };
+    int first_direct = 0;
+    if (far_count > 0 && background_far_cache_prepare(renderer, cache, layers, far_count, screen_width, screen_height)) {
+        int offsets_x[BG_MAX_FAR_LAYERS], offsets_y[BG_MAX_FAR_LAYERS];
+        bool changed = !cache->valid || cache->layer_count != far_count;
+        for (int i = 0; i < far_count; i++) {
+            background_layer_offsets(layers[i], camera_x, camera_y, &offsets_x[i], &offsets_y[i]);
+            if (offsets_x[i] != cache->last_offset_x[i] || offsets_y[i] != cache->last_offset_y[i]) changed = true;
+        }
+
+        // Under load a moved composite waits one frame, the far layers barely move
+        if (changed && cache->valid && cache->layer_count == far_count && cache->half_rate && !cache->skipped_last) {
+            changed = false;
+            cache->skipped_last = true;
+        } else {
+            cache->skipped_last = false;
+        }
+
+        // 2. Redraw the composite only when an integer scroll offset moved
+        if (changed) {
+            SDL_Texture *old_target = SDL_GetRenderTarget(renderer);
+            render_set_target(renderer, RENDER_SUB_BACKGROUND, cache->texture);
+            render_set_draw_color(renderer, RENDER_SUB_BACKGROUND, 0, 0, 0, 0);
+            render_clear(renderer, RENDER_SUB_BACKGROUND);
+            for (int i = 0; i < far_count; i++) {
+                // The composite is reused by later frames, it is always drawn whole
+                background_layer_draw(renderer, layers[i], offsets_x[i], offsets_y[i], cache->w, cache->h, NULL);
+                cache->last_offset_x[i] = offsets_x[i];
+                cache->last_offset_y[i] = offsets_y[i];
+            }
+            render_set_target(renderer, RENDER_SUB_BACKGROUND, old_target);
+            cache->layer_count = far_count;
+            cache->valid = true;
+        }
+
+        SDL_Rect dst = { 0, 0, cache->w, cache->h };
+        SDL_Rect screen = { 0, 0, screen_width, screen_height };
+        background_copy(renderer, cache->texture, 0, 0, &dst, &screen, clip);
+        first_direct = far_count;
+    }
 
-        SDL_RenderCopy(renderer, layer->texture, NULL, &dest_rect);
+    // 3. Mid / fore layers move too fast to cache
+    for (int i = first_direct; i < count; i++) {
+        background_layer_render(renderer, layers[i], camera_x, camera_y, screen_width, screen_height, clip);
+    }
 
-        // Move forward by scaled width
-        current_draw_x += w;
+    g_pixels.frames++;
+#ifdef PERF_ENABLED
+    if (g_pixels.frames >= PERF_REPORT_INTERVAL) {
+        debug_log("BG_PIXELS: %u Pixel pro Frame gezeichnet, ohne Clipping %u (%u%%)",
+                  (unsigned)(g_pixels.drawn / g_pixels.frames), (unsigned)(g_pixels.unclipped / g_pixels.frames),
+                  (unsigned)(g_pixels.unclipped ? g_pixels.drawn * 100 / g_pixels.unclipped : 100));
+        g_pixels = (BackgroundPixels){0};
     }
+#endif
 }
 
 void background_layer_cleanup(BackgroundLayer *layer) {
     if (layer->texture) {
         debug_log("BG_CLEANUP: Textur freigegeben.");
-        SDL_DestroyTexture(layer->texture);
+        mem_track_texture_destroy(layer->texture);
         layer->texture = NULL;
     }
-}
\ No newline at end of file
+}
+
+void background_far_cache_cleanup(BackgroundFarCache *cache) {
+    if (cache->texture) {
+        mem_track_texture_destroy(cache->texture);
+        cache->texture = NULL;
+    }
+    cache->valid = false;
+    cache->target_failed = false;
+    cache->layer_count = 0;
+}
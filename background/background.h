@@ -2,17 +2,52 @@
 #define BACKGROUND_H
 
 #include <SDL.h>
+#include <stdbool.h>
+
+// Layers at or below this scroll speed are composited into the far cache
+#define BG_FAR_SPEED_MAX 0.1f
+#define BG_MAX_FAR_LAYERS 4
 
 typedef struct {
-    SDL_Texture *texture;
+    SDL_Texture *texture; // pre-scaled strip, image repeated until it covers the screen width
+    int tile_w;           // width of one scaled image (wrap period)
+    int strip_w, strip_h; // size of the strip texture
     float scroll_speed;
     float scale;
 } BackgroundLayer;
 
-BackgroundLayer background_layer_init(SDL_Renderer *renderer, const char *path, float speed, float scale);
+// Composite of the slow far layers, only redrawn when their integer scroll offset changes
+typedef struct {
+    SDL_Texture *texture;
+    int w, h;
+    int layer_count;
+    int last_offset_x[BG_MAX_FAR_LAYERS];
+    int last_offset_y[BG_MAX_FAR_LAYERS];
+    bool valid;
+    bool target_failed;
+    bool half_rate;       // set by the caller: redraw at most every other frame, the composite may lag a frame
+    bool skipped_last;
+} BackgroundFarCache;
+
+// Screen areas the backgrounds still show through (map_uncovered_rects); rects NULL = whole screen
+typedef struct {
+    const SDL_Rect *rects;
+    int count;
+} BackgroundClip;
+
+// Rows the vertical parallax cannot reach with the camera between 0 and max_camera_y are dropped from the strip
+BackgroundLayer background_layer_init(SDL_Renderer *renderer, const char *path, float speed, float scale, int screen_width, int screen_height,
+                                      int max_camera_y);
+
+// clip may be NULL
+void background_layer_render(SDL_Renderer *renderer, const BackgroundLayer *layer, int camera_x, int camera_y, int screen_width, int screen_height,
+                             const BackgroundClip *clip);
 
-void background_layer_render(SDL_Renderer *renderer, const BackgroundLayer *layer, int camera_x, int camera_y, int screen_width, int screen_height);
+// Renders all layers back to front, only inside clip (may be NULL); leading far layers go through the cache
+void background_render(SDL_Renderer *renderer, BackgroundFarCache *cache, BackgroundLayer *layers[], int count, int camera_x, int camera_y,
+                       int screen_width, int screen_height, const BackgroundClip *clip);
 
 void background_layer_cleanup(BackgroundLayer *layer);
+void background_far_cache_cleanup(BackgroundFarCache *cache);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,5 +1,9 @@
 #include "bgmHandler.h"
+#include "voiceManager.h"
+#include "../assets/assetPack.h"
+#include "../memory/memTrack.h"
 #include <stdio.h>
+#include <string.h>
 
 extern void debug_log(const char *format, ...);
 
@@ -21,7 +25,8 @@ bool audio_system_init() {
         return false;
     }
 
-    Mix_AllocateChannels(16);
+    Mix_AllocateChannels(VOICE_CHANNELS);
+    voice_init();
     g_audio_initialized = true;
     debug_log("audio ready.\n");
     return true;
@@ -29,6 +34,7 @@ bool audio_system_init() {
 
 void audio_cleanup() {
     if (g_audio_initialized) {
+        voice_stop_all();
         Mix_CloseAudio();
         SDL_QuitSubSystem(SDL_INIT_AUDIO);
         g_audio_initialized = false;
@@ -42,21 +48,76 @@ bool bgm_init() {
     return audio_system_init();
 }
 
+static int bgm_loader_thread(void* data) {
+    BGMHandler* bgm = data;
+    // Only opens the stream, the mixer itself is not touched from here
+    bgm->next = Mix_LoadMUS_RW(asset_open(bgm->next_path), 1);
+    if (!bgm->next) snprintf(bgm->loader_error, sizeof(bgm->loader_error), "%s", Mix_GetError());
+    SDL_AtomicSet(&bgm->loader_done, 1);
+    return 0;
+}
+
+static void bgm_wait_loader(BGMHandler* bgm) {
+    if (!bgm->loader) return;
+    SDL_WaitThread(bgm->loader, NULL);
+    bgm->loader = NULL;
+}
+
 void bgm_play(BGMHandler* bgm, const char* path, int loops) {
-    if (!bgm || !g_audio_initialized) return;
-    if (bgm->music) {
-        Mix_HaltMusic();
-        Mix_FreeMusic(bgm->music);
-        bgm->music = NULL;
+    if (!bgm || !path || !g_audio_initialized) return;
+
+    // Same track across a level switch: just keep streaming
+    if (bgm->state == BGM_IDLE && bgm->music && strcmp(bgm->path, path) == 0) return;
+    if (bgm->state != BGM_IDLE && strcmp(bgm->next_path, path) == 0) return;
+
+    // A different request while one is pending replaces it
+    bgm_wait_loader(bgm);
+    if (bgm->next) {
+        Mix_FreeMusic(bgm->next);
+        bgm->next = NULL;
     }
 
-    bgm->music = Mix_LoadMUS(path);
-    if (!bgm->music) {
-        debug_log("BGM error: %s (path: %s)\n", Mix_GetError(), path);
-        return;
+    snprintf(bgm->next_path, sizeof(bgm->next_path), "%s", path);
+    bgm->next_loops = loops;
+    bgm->loader_error[0] = '\0';
+    SDL_AtomicSet(&bgm->loader_done, 0);
+    bgm->state = BGM_LOADING;
+
+    if (Mix_PlayingMusic()) Mix_FadeOutMusic(BGM_FADE_MS);
+
+    bgm->loader = SDL_CreateThread(bgm_loader_thread, "bgm_loader", bgm);
+    if (!bgm->loader) {
+        // No thread available: open it right here
+        bgm_loader_thread(bgm);
     }
+}
+
+void bgm_update(BGMHandler* bgm) {
+    if (!bgm || bgm->state == BGM_IDLE) return;
+
+    if (bgm->state == BGM_LOADING) {
+        if (!SDL_AtomicGet(&bgm->loader_done)) return;
+        bgm_wait_loader(bgm);
+        if (!bgm->next) {
+            debug_log("BGM error: %s (path: %s)\n", bgm->loader_error, bgm->next_path);
+            bgm->next_path[0] = '\0';
+            bgm->state = BGM_IDLE;
+            return;
+        }
+        bgm->state = BGM_SWITCHING;
+    }
+
+    // Old track still fading out
+    if (Mix_PlayingMusic()) return;
 
-    Mix_PlayMusic(bgm->music, loops);
+    if (bgm->music) Mix_FreeMusic(bgm->music);
+    bgm->music = bgm->next;
+    bgm->next = NULL;
+    snprintf(bgm->path, sizeof(bgm->path), "%s", bgm->next_path);
+    bgm->next_path[0] = '\0';
+    bgm->state = BGM_IDLE;
+
+    Mix_FadeInMusic(bgm->music, bgm->next_loops, BGM_FADE_MS);
 }
 
 void bgm_stop(BGMHandler* bgm) {
@@ -64,10 +125,20 @@ void bgm_stop(BGMHandler* bgm) {
 }
 
 void bgm_cleanup(BGMHandler* bgm) {
-    if (bgm && bgm->music) {
+    if (!bgm) return;
+    bgm_wait_loader(bgm);
+    Mix_HaltMusic();
+    if (bgm->next) {
+        Mix_FreeMusic(bgm->next);
+        bgm->next = NULL;
+    }
+    if (bgm->music) {
         Mix_FreeMusic(bgm->music);
         bgm->music = NULL;
     }
+    bgm->path[0] = '\0';
+    bgm->next_path[0] = '\0';
+    bgm->state = BGM_IDLE;
 }
 
 // --- SFX ---
@@ -76,17 +147,93 @@ bool sfx_init() {
     return audio_system_init();
 }
 
+// Every chunk is loaded once and shared by reference count
+typedef struct {
+    char path[SFX_PATH_MAX];
+    Mix_Chunk* chunk;
+    int refs;
+} SFXBankEntry;
+
+static SFXBankEntry g_sfx_bank[SFX_BANK_MAX];
+static Uint32 g_sfx_load_ms = 0;   // since the last report
+static int g_sfx_loads = 0;
+
+// tools/convert_sfx.py writes mixer-native copies to a "mixer" folder next to the source
+static Mix_Chunk* sfx_load_file(const char* path) {
+    char converted[SFX_PATH_MAX];
+    const char* slash = strrchr(path, '/');
+    int dir_len = slash ? (int)(slash - path) + 1 : 0;
+    snprintf(converted, sizeof(converted), "%.*smixer/%s", dir_len, path, path + dir_len);
+
+    SDL_RWops* rw = asset_open(converted);
+    if (!rw) rw = asset_open(path);
+    return rw ? Mix_LoadWAV_RW(rw, 1) : NULL;
+}
+
 Mix_Chunk* sfx_load(const char* path) {
-    if (!g_audio_initialized) return NULL;
-    Mix_Chunk* chunk = Mix_LoadWAV(path);
-    if (!chunk) debug_log("SFX Fehler: %s\n", Mix_GetError());
+    if (!g_audio_initialized || !path) return NULL;
+
+    int free_slot = -1;
+    for (int i = 0; i < SFX_BANK_MAX; i++) {
+        if (g_sfx_bank[i].chunk && strcmp(g_sfx_bank[i].path, path) == 0) {
+            g_sfx_bank[i].refs++;
+            return g_sfx_bank[i].chunk;
+        }
+        if (!g_sfx_bank[i].chunk && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) {
+        debug_log("SFX Fehler: Bank voll (%d), %s nicht geladen\n", SFX_BANK_MAX, path);
+        return NULL;
+    }
+
+    Uint32 start = SDL_GetTicks();
+    Mix_Chunk* chunk = sfx_load_file(path);
+    if (!chunk) {
+        debug_log("SFX Fehler: %s\n", Mix_GetError());
+        return NULL;
+    }
+    g_sfx_load_ms += SDL_GetTicks() - start;
+    g_sfx_loads++;
+    mem_track_add(MEM_TAG_AUDIO, chunk->alen);
+
+    SFXBankEntry* entry = &g_sfx_bank[free_slot];
+    snprintf(entry->path, sizeof(entry->path), "%s", path);
+    entry->chunk = chunk;
+    entry->refs = 1;
     return chunk;
 }
 
-void sfx_play(Mix_Chunk* sfx, int loops) {
-    if (sfx) Mix_PlayChannel(-1, sfx, loops);
+void sfx_bank_report(const char* label) {
+    int count = 0;
+    Uint32 bytes = 0;
+    for (int i = 0; i < SFX_BANK_MAX; i++) {
+        if (!g_sfx_bank[i].chunk) continue;
+        count++;
+        bytes += g_sfx_bank[i].chunk->alen;
+    }
+    debug_log("SFX_BANK: %s - %d Sounds resident (%u KB), %d neu geladen in %u ms",
+              label, count, (unsigned)(bytes / 1024), g_sfx_loads, (unsigned)g_sfx_load_ms);
+    g_sfx_loads = 0;
+    g_sfx_load_ms = 0;
+}
+
+int sfx_play(Mix_Chunk* sfx, int loops) {
+    // Plain sounds go through the voice manager as well, it owns every channel
+    VoiceSound sound = { sfx, VOICE_PRIORITY_DEFAULT, VOICE_DEFAULT_MAX_INSTANCES, MIX_MAX_VOLUME };
+    return voice_play(&sound, loops);
 }
 
 void sfx_cleanup(Mix_Chunk* sfx) {
-    if (sfx) Mix_FreeChunk(sfx);
+    if (!sfx) return;
+    for (int i = 0; i < SFX_BANK_MAX; i++) {
+        if (g_sfx_bank[i].chunk != sfx) continue;
+        if (--g_sfx_bank[i].refs > 0) return;
+        mem_track_sub(MEM_TAG_AUDIO, sfx->alen);
+        Mix_FreeChunk(sfx);
+        g_sfx_bank[i].chunk = NULL;
+        g_sfx_bank[i].path[0] = '\0';
+        return;
+    }
+    // not from the bank
+    Mix_FreeChunk(sfx);
 }
\ No newline at end of file
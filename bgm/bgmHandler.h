@@ -5,8 +5,33 @@
 #include <SDL2/SDL_mixer.h>
 #include <stdbool.h>
 
+#define BGM_FADE_MS 800
+#define BGM_PATH_MAX 128
+#define BGM_ERROR_MAX 128
+
+typedef enum {
+    BGM_IDLE,
+    BGM_LOADING,     // next track is opened on the loader thread
+    BGM_SWITCHING    // next track ready, waiting for the old one to fade out
+} BGMState;
+
+/*
+ * Mix_Music streams from disk: SDL_mixer decodes the OGG in small chunks
+ * inside the audio callback, so memory stays at the decoder buffers.
+ * Opening a track (file + Vorbis headers) runs on a loader thread and
+ * overlaps with the fade-out of the current one.
+ */
 typedef struct {
     Mix_Music* music;    
+    char path[BGM_PATH_MAX];
+
+    Mix_Music* next;
+    char next_path[BGM_PATH_MAX];
+    int next_loops;
+    SDL_Thread* loader;
+    SDL_atomic_t loader_done;
+    char loader_error[BGM_ERROR_MAX]; // SDL errors are per thread, copied on the loader thread
+    BGMState state;
 } BGMHandler;
 
 // Struktur für Soundeffekte
@@ -19,14 +44,23 @@ void audio_cleanup();
 
 // --- BGM Funktionen ---
 bool bgm_init();
+// Keeps playing if path is already the current track, otherwise preloads and fades over
 void bgm_play(BGMHandler* bgm, const char* path, int loops);
+// Finishes a pending track switch, call once per frame
+void bgm_update(BGMHandler* bgm);
 void bgm_stop(BGMHandler* bgm);
 void bgm_cleanup(BGMHandler* bgm);
 
 // --- SFX Funktionen ---
+#define SFX_BANK_MAX 32
+#define SFX_PATH_MAX 128
+
+// Shared and reference counted: the same path returns the same chunk, pair with sfx_cleanup
 Mix_Chunk* sfx_load(const char* path);
+// Logs resident sounds/bytes and the load time since the previous report
+void sfx_bank_report(const char* label);
 bool sfx_init();
-void sfx_play(Mix_Chunk* sfx, int loops);
+int sfx_play(Mix_Chunk* sfx, int loops); // returns a VoiceHandle or -1
 void sfx_cleanup(Mix_Chunk* sfx);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "voiceManager.h"
+#include <math.h>
+#include <string.h>
+
+extern void debug_log(const char *format, ...);
+
+typedef struct {
+    const Mix_Chunk* chunk;
+    Uint32 started;     // FrameClock tick, ties go to the lower channel
+    float x, y;
+    Uint16 generation;
+    Uint8 priority;
+    Uint8 volume;       // base volume of the sound
+    Uint8 gain_volume;  // volume after attenuation, used to pick a victim
+    Sint8 pan_step;     // last applied pan in 1/8 steps
+    bool positional;
+    bool active;
+} Voice;
+
+static Voice g_voices[VOICE_CHANNELS];
+static float g_listener_x = 0.0f;
+static float g_listener_y = 0.0f;
+static Uint32 g_voice_now = 0;   // tick passed to the last voice_update
+
+#define VOICE_HANDLE(ch) ((int)((g_voices[ch].generation & 0x7FFF) << 8) | (ch))
+#define VOICE_CHANNEL(h) ((h) & 0xFF)
+
+void voice_init(void) {
+    memset(g_voices, 0, sizeof(g_voices));
+}
+
+void voice_set_listener(float x, float y) {
+    g_listener_x = x;
+    g_listener_y = y;
+}
+
+static Voice* voice_from_handle(VoiceHandle handle) {
+    if (handle < 0) return NULL;
+    int ch = VOICE_CHANNEL(handle);
+    if (ch >= VOICE_CHANNELS) return NULL;
+    Voice* v = &g_voices[ch];
+    if (!v->active || VOICE_HANDLE(ch) != handle) return NULL;
+    return v;
+}
+
+// Volume after distance falloff, 0 when out of hearing range
+static int voice_gain(int volume, bool positional, float x, float y, float* pan) {
+    *pan = 0.0f;
+    if (!positional) return volume;
+
+    float dx = x - g_listener_x;
+    float dy = y - g_listener_y;
+    float dist = sqrtf(dx * dx + dy * dy);
+    if (dist >= VOICE_HEARING_RANGE) return 0;
+
+    *pan = dx / VOICE_HEARING_RANGE;
+    return (int)(volume * (1.0f - dist / VOICE_HEARING_RANGE));
+}
+
+#define VOICE_PAN_STEP(pan) ((Sint8)((pan) * 8.0f))
+
+static void voice_apply(int ch, int gain_volume, float pan) {
+    g_voices[ch].gain_volume = (Uint8)gain_volume;
+    g_voices[ch].pan_step = VOICE_PAN_STEP(pan);
+    Mix_Volume(ch, gain_volume);
+
+    // 255/255 unregisters SDL_mixer's panning effect, so centered sounds cost nothing extra
+    if (fabsf(pan) < VOICE_PAN_DEADZONE) {
+        Mix_SetPanning(ch, 255, 255);
+    } else {
+        if (pan > 1.0f) pan = 1.0f;
+        if (pan < -1.0f) pan = -1.0f;
+        Uint8 left = (Uint8)(pan > 0 ? 255 * (1.0f - pan) : 255);
+        Uint8 right = (Uint8)(pan < 0 ? 255 * (1.0f + pan) : 255);
+        Mix_SetPanning(ch, left, right);
+    }
+}
+
+static void voice_release(int ch) {
+    g_voices[ch].active = false;
+    g_voices[ch].generation++;
+}
+
+// Free channel, else the oldest instance of the same chunk once the cap is hit,
+// else the weakest voice that does not outrank the new one
+static int voice_pick_channel(const VoiceSound* sound, int gain_volume) {
+    int instances = 0;
+    int oldest_same = -1;
+    int free_ch = -1;
+
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        Voice* v = &g_voices[ch];
+        if (v->active && !Mix_Playing(ch)) voice_release(ch);
+        if (!v->active) {
+            if (free_ch < 0) free_ch = ch;
+            continue;
+        }
+        if (v->chunk == sound->chunk) {
+            instances++;
+            if (oldest_same < 0 || v->started < g_voices[oldest_same].started) oldest_same = ch;
+        }
+    }
+
+    int max_instances = sound->max_instances ? sound->max_instances : VOICE_DEFAULT_MAX_INSTANCES;
+    if (instances >= max_instances) return oldest_same;
+    if (free_ch >= 0) return free_ch;
+
+    int victim = -1;
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        Voice* v = &g_voices[ch];
+        if (v->priority > sound->priority) continue;
+        if (v->priority == sound->priority && v->gain_volume > gain_volume) continue;
+        if (victim < 0) { victim = ch; continue; }
+
+        Voice* best = &g_voices[victim];
+        if (v->priority != best->priority) {
+            if (v->priority < best->priority) victim = ch;
+        } else if (v->gain_volume != best->gain_volume) {
+            if (v->gain_volume < best->gain_volume) victim = ch;
+        } else if (v->started < best->started) {
+            victim = ch;
+        }
+    }
+    return victim;
+}
+
+static VoiceHandle voice_start(const VoiceSound* sound, int loops, bool positional, float x, float y) {
+    if (!sound || !sound->chunk) return -1;
+
+    float pan;
+    int gain_volume = voice_gain(sound->volume, positional, x, y, &pan);
+    // Inaudible: never reaches the mixer
+    if (gain_volume < VOICE_MIN_VOLUME) return -1;
+
+    int ch = voice_pick_channel(sound, gain_volume);
+    if (ch < 0) return -1;
+
+    if (g_voices[ch].active) {
+        Mix_HaltChannel(ch);
+        voice_release(ch);
+    }
+
+    voice_apply(ch, gain_volume, pan);
+    if (Mix_PlayChannel(ch, sound->chunk, loops) < 0) {
+        debug_log("VOICE: Kanal %d Fehler: %s", ch, Mix_GetError());
+        return -1;
+    }
+
+    Voice* v = &g_voices[ch];
+    v->chunk = sound->chunk;
+    v->started = g_voice_now;
+    v->x = x;
+    v->y = y;
+    v->priority = sound->priority;
+    v->volume = sound->volume;
+    v->positional = positional;
+    v->active = true;
+    return VOICE_HANDLE(ch);
+}
+
+VoiceHandle voice_play_at(const VoiceSound* sound, int loops, float x, float y) {
+    return voice_start(sound, loops, true, x, y);
+}
+
+VoiceHandle voice_play(const VoiceSound* sound, int loops) {
+    return voice_start(sound, loops, false, 0.0f, 0.0f);
+}
+
+void voice_set_position(VoiceHandle handle, float x, float y) {
+    Voice* v = voice_from_handle(handle);
+    if (!v) return;
+    v->x = x;
+    v->y = y;
+}
+
+bool voice_is_playing(VoiceHandle handle) {
+    Voice* v = voice_from_handle(handle);
+    return v && Mix_Playing(VOICE_CHANNEL(handle));
+}
+
+void voice_stop(VoiceHandle handle) {
+    if (!voice_from_handle(handle)) return;
+    int ch = VOICE_CHANNEL(handle);
+    Mix_HaltChannel(ch);
+    voice_release(ch);
+}
+
+void voice_stop_all(void) {
+    Mix_HaltChannel(-1);
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        if (g_voices[ch].active) voice_release(ch);
+    }
+}
+
+void voice_update(Uint32 now) {
+    g_voice_now = now;
+    for (int ch = 0; ch < VOICE_CHANNELS; ch++) {
+        Voice* v = &g_voices[ch];
+        if (!v->active) continue;
+        if (!Mix_Playing(ch)) { voice_release(ch); continue; }
+        if (!v->positional) continue;
+
+        float pan;
+        int gain_volume = voice_gain(v->volume, true, v->x, v->y, &pan);
+        if (gain_volume < VOICE_MIN_VOLUME) {
+            // out of range: stop mixing it, the owner restarts it when it comes back
+            Mix_HaltChannel(ch);
+            voice_release(ch);
+            continue;
+        }
+        if (gain_volume != v->gain_volume || VOICE_PAN_STEP(pan) != v->pan_step) voice_apply(ch, gain_volume, pan);
+    }
+}
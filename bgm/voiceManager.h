@@ -0,0 +1,46 @@
+#ifndef VOICE_MANAGER_H
+#define VOICE_MANAGER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <stdbool.h>
+
+#define VOICE_CHANNELS 16             // Mixer-Kanaele, gehoeren alle dem Voice Manager
+#define VOICE_HEARING_RANGE 480.0f    // px vom Kamerazentrum bis zur Stille
+#define VOICE_MIN_VOLUME 6            // leiser als das wird gar nicht erst gemischt
+#define VOICE_PAN_DEADZONE 0.15f      // kleine Auslenkung bleibt ohne Panning-Effekt
+
+// Higher priority may steal channels from lower ones
+#define VOICE_PRIORITY_AMBIENT 0
+#define VOICE_PRIORITY_ENEMY   1
+#define VOICE_PRIORITY_DEFAULT 2
+#define VOICE_PRIORITY_PLAYER  3
+
+#define VOICE_DEFAULT_MAX_INSTANCES 4
+
+// How a sound may be played, usually stored next to the chunk it describes
+typedef struct {
+    Mix_Chunk* chunk;
+    Uint8 priority;
+    Uint8 max_instances;   // gleichzeitige Instanzen dieses Chunks
+    Uint8 volume;          // 0..MIX_MAX_VOLUME
+} VoiceSound;
+
+// Channel plus generation, stays invalid once the channel was reused. -1 = none
+typedef int VoiceHandle;
+
+void voice_init(void);
+void voice_set_listener(float x, float y);
+// Positional sound, attenuated and panned by distance to the listener
+VoiceHandle voice_play_at(const VoiceSound* sound, int loops, float x, float y);
+// Non-positional sound (UI, player)
+VoiceHandle voice_play(const VoiceSound* sound, int loops);
+void voice_set_position(VoiceHandle handle, float x, float y);
+bool voice_is_playing(VoiceHandle handle);
+void voice_stop(VoiceHandle handle);
+void voice_stop_all(void);
+// Reaps finished voices and re-applies distance for moving sources / listener, once per frame.
+// now is the FrameClock tick, voices started until the next call count as started then.
+void voice_update(Uint32 now);
+
+#endif
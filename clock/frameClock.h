@@ -0,0 +1,29 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <SDL.h>
+
+// One simulation tick per displayed frame (vsync)
+#define FRAME_CLOCK_HZ 60
+
+// Design times stay in ms, gameplay timers count ticks (rounded, at least 1)
+#define FRAME_TICKS(ms) ((Uint32)(((ms) * FRAME_CLOCK_HZ + 500) / 1000) > 0 ? \
+                         (Uint32)(((ms) * FRAME_CLOCK_HZ + 500) / 1000) : 1u)
+
+/*
+ * Sampled once per frame in main and handed down through update and render.
+ * Every system sees the same "now" for the whole frame; gameplay only reads
+ * tick, so a run is reproducible from its input. real_ms is the one
+ * SDL_GetTicks of the frame, for logging and profiling.
+ */
+typedef struct FrameClock {
+    Uint32 tick;
+    Uint32 real_ms;
+} FrameClock;
+
+static inline void frame_clock_advance(FrameClock *clock) {
+    clock->tick++;
+    clock->real_ms = SDL_GetTicks();
+}
+
+#endif
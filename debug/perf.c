@@ -0,0 +1,24 @@
+#include "perf.h"
+
+extern void debug_log(const char *format, ...);
+
+void perf_begin(PerfTimer *timer) {
+    timer->start = SDL_GetPerformanceCounter();
+}
+
+void perf_end(PerfTimer *timer) {
+    Uint64 elapsed = SDL_GetPerformanceCounter() - timer->start;
+    timer->total += elapsed;
+    if (elapsed > timer->worst) timer->worst = elapsed;
+    timer->samples++;
+
+    if (timer->samples >= PERF_REPORT_INTERVAL) {
+        double freq = (double)SDL_GetPerformanceFrequency();
+        double avg_us = (double)timer->total / timer->samples * 1000000.0 / freq;
+        double worst_us = (double)timer->worst * 1000000.0 / freq;
+        debug_log("PERF: %s avg %.1f us, worst %.1f us (%u samples)", timer->name, avg_us, worst_us, timer->samples);
+        timer->total = 0;
+        timer->worst = 0;
+        timer->samples = 0;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <SDL.h>
+
+// Averaged timings are written to the debug log every PERF_REPORT_INTERVAL samples
+#define PERF_REPORT_INTERVAL 300
+
+typedef struct {
+    const char *name;
+    Uint64 start;
+    Uint64 total;
+    Uint64 worst;
+    Uint32 samples;
+} PerfTimer;
+
+void perf_begin(PerfTimer *timer);
+void perf_end(PerfTimer *timer);
+
+// Compiled out unless the build enables PERF_ENABLED (cmake -DPERF_BENCHMARK=ON)
+#ifdef PERF_ENABLED
+#define PERF_TIMER(name) static PerfTimer name = { #name, 0, 0, 0, 0 }
+#define PERF_BEGIN(name) perf_begin(&name)
+#define PERF_END(name)   perf_end(&name)
+#else
+#define PERF_TIMER(name)
+#define PERF_BEGIN(name) ((void)0)
+#define PERF_END(name)   ((void)0)
+#endif
+
+#endif
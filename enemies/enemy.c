@@ -5,177 +5,427 @@
 #include <stdlib.h>
 #include <math.h>
 #include "../map/map.h" // Ensure we can see the Map struct
+#include "../map/mapRaycast.h"
 #include "../enemies/melee.h"
 #include "../enemies/ranged.h"
+#include "../render/renderSnapshot.h"
+#include "../texture/textureResidency.h"
+#include "../render/qualityGovernor.h"
 
 // Physics Constants (Same as Player for consistency)
 #define ENEMY_GRAVITY 0.4f
 #define ENEMY_MAX_FALL_SPEED 10.0f
+// Horizontal nudge per overlapping neighbour so packs don't stack on one spot
+#define ENEMY_SEPARATION_PUSH 0.5f
+
+#define ENEMY_EDGE_TICK_DIV 4      // edge enemies update every 4th frame, staggered by index, with 4 physics steps
+// QUALITY_DISTANT_HALF_RATE: on-screen enemies farther than this from the player animate every other frame
+#define ENEMY_NEAR_RANGE 160
 
-extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
 extern void debug_log(const char *format, ...);
 
-void enemy_cleanup(Enemy *enemy) {
-    entity_cleanup(&enemy->entity);
-    if (enemy->attack_type == RANGED) {
-        RangedEnemy *re = (RangedEnemy *)enemy;
-        projectile_sprite_cleanup(re);
+void enemy_type_set_hitbox(EnemyTypeInfo *type, float scale_w, float scale_h) {
+    // Known without the textures, idle may be a lazy clip that is not loaded yet
+    if (type->idle.count > 0) {
+        type->sprite_w = type->idle.sprite_w;
+        type->sprite_h = type->idle.sprite_h;
     }
+
+    type->hitbox_w = (int)(type->sprite_w * scale_w);
+    type->hitbox_h = (int)(type->sprite_h * scale_h);
+    type->offset_x = (type->sprite_w - type->hitbox_w) / 2;
+    type->offset_y = type->sprite_h - type->hitbox_h;
 }
 
-void enemy_update(Enemy *enemy, Player *player, struct Map *map) {
-    Entity *e = &enemy->entity;
-    Uint32 now = SDL_GetTicks();
+static void enemy_grunt_stop(EnemyStore *store, int i) {
+    if (store->grunt_voice[i] >= 0) {
+        voice_stop(store->grunt_voice[i]);
+        store->grunt_voice[i] = -1;
+    }
+}
 
-    // 1. Death / Dying Check
-    if (enemy->entity.is_dying) {
-        entity_update_death(&enemy->entity);
+static void enemy_update_death(EnemyStore *store, int i, const EnemyTypeInfo *type, Uint32 now) {
+    enemy_grunt_stop(store, i);
+    if (type->death.count == 0) {
+        store->flags[i] |= ENEMY_FLAG_DEAD;
+        spatial_grid_remove(&store->grid, i);
         return;
     }
-    if (enemy->entity.is_dead) {
-        return;
+    if (now - store->anim_time[i] < FRAME_TICKS(100)) return;
+    store->anim_time[i] = now;
+    store->frame_death[i]++;
+    if (store->alpha[i] > 10) store->alpha[i] -= 10; else store->alpha[i] = 0;
+    if (store->frame_death[i] >= type->death.count) {
+        store->flags[i] |= ENEMY_FLAG_DEAD;
+        store->flags[i] &= (Uint8)~ENEMY_FLAG_DYING;
+        spatial_grid_remove(&store->grid, i);
     }
+}
 
-    // 2. AI LOGIC
-    float p_center_x = player->entity.rect.x + player->entity.rect.w / 2.0f;
-    float e_center_x = e->rect.x + e->rect.w / 2.0f;
-    float diff_x = p_center_x - e_center_x;
-    float distance = fabs(diff_x);
-
-    e->vel_x = 0;
-    enemy->is_moving = 0;
-
-    // Face Player
-    if (diff_x > 0) e->flip_direction = SDL_FLIP_NONE;
-    else e->flip_direction = SDL_FLIP_HORIZONTAL;
-
-    if (enemy->attack_type == RANGED) { // ShurikenDude frames inverted compared to other enemies
-        if (e->flip_direction == SDL_FLIP_NONE) {
-            e->flip_direction = SDL_FLIP_HORIZONTAL;
-        } else {
-            e->flip_direction = SDL_FLIP_NONE;
-        }
-    }
+static void enemy_update_animation(EnemyStore *store, int i, const EnemyTypeInfo *type, Uint32 now) {
+    if (now - store->anim_time[i] < FRAME_TICKS(ENEMY_ANIMATION_SPEED)) return;
 
-    if (now >= enemy->attack_timer_end) {
-        if (distance < enemy->detection_range && distance > 5.0f) {
-            e->vel_x = (diff_x > 0) ? ENEMY_SPEED : -ENEMY_SPEED;
-            enemy->is_moving = 1;
-        }
+    if (now < store->attack_timer_end[i]) {
+        store->frame_attack[i]++;
+        if (store->frame_attack[i] >= type->attack.count) store->frame_attack[i] = 0;
+    } else if ((store->flags[i] & ENEMY_FLAG_MOVING) && type->run.count > 0) {
+        store->frame_run[i] = (store->frame_run[i] + 1) % type->run.count;
+    } else if (!(store->flags[i] & ENEMY_FLAG_MOVING) && type->idle.count > 0) {
+        store->frame_idle[i] = (store->frame_idle[i] + 1) % type->idle.count;
     }
+    store->anim_time[i] = now;
+}
 
-    // 3. PHYSICS UPDATE
-    // Replaced manual physics with the robust system
-    entity_update_physics(e, map, ENEMY_GRAVITY, ENEMY_MAX_FALL_SPEED);
+typedef struct {
+    const EnemyStore *store;
+    int self;
+    int self_center;
+    float push;
+} EnemySeparation;
 
-    // Death floor check
-    if (e->rect.y > 600) e->health = 0;
+static bool enemy_separation_visit(void *ctx, int j) {
+    EnemySeparation *sep = ctx;
+    const EnemyStore *store = sep->store;
+    int i = sep->self;
+    if (j == i || (store->flags[j] & (ENEMY_FLAG_DYING | ENEMY_FLAG_DEAD))) return true;
+    if (!SDL_HasIntersection(&store->rect[i], &store->rect[j])) return true;
 
-    // 4. ANIMATION
-    enemy_update_animation(enemy);
+    int other_center = store->rect[j].x + store->rect[j].w / 2;
+    if (sep->self_center < other_center || (sep->self_center == other_center && i < j)) sep->push -= ENEMY_SEPARATION_PUSH;
+    else sep->push += ENEMY_SEPARATION_PUSH;
+    return true;
 }
 
-void enemy_render(SDL_Renderer *renderer, Enemy *enemy, int camera_x, int camera_y) {
-    Entity *e = &enemy->entity;
-    if (e->is_dead) return;
+static float enemy_separation(const EnemyStore *store, int i) {
+    const SDL_Rect *self = &store->rect[i];
+    EnemySeparation sep = { store, i, self->x + self->w / 2, 0 };
+    spatial_grid_visit(&store->grid, self, enemy_separation_visit, &sep);
 
-    SDL_Texture *current_texture = NULL;
-    Uint32 now = SDL_GetTicks();
-    sfx_play(enemy->entity.grunt_sfx, -1);
+    float push = sep.push;
+    if (push > ENEMY_SPEED) push = ENEMY_SPEED;
+    if (push < -ENEMY_SPEED) push = -ENEMY_SPEED;
+    return push;
+}
 
-    if (e->is_dying && e->death.count > 0) {
-        current_texture = e->death.frames[e->current_death_frame];
-        SDL_SetTextureAlphaMod(current_texture, e->alpha);
-    }
-    else if (now < enemy->attack_timer_end && e->attack.count > 0) {
-        current_texture = e->attack.frames[e->current_attack_frame];
+static int enemy_cmp_index(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// Rebuilds the awake list from the grid, enemies outside the edge region are not touched at all
+static void enemies_update_activation(EnemyStore *store, const SDL_Rect *view) {
+    SDL_Rect active = { view->x - ENEMY_ACTIVE_MARGIN, view->y - ENEMY_ACTIVE_MARGIN,
+                        view->w + 2 * ENEMY_ACTIVE_MARGIN, view->h + 2 * ENEMY_ACTIVE_MARGIN };
+    SDL_Rect edge = { view->x - ENEMY_EDGE_MARGIN, view->y - ENEMY_EDGE_MARGIN,
+                      view->w + 2 * ENEMY_EDGE_MARGIN, view->h + 2 * ENEMY_EDGE_MARGIN };
+
+    // Whoever was awake last frame falls asleep unless the query finds them again
+    for (int k = 0; k < store->awake_count; k++) {
+        store->activation[store->awake[k]] = ENEMY_ASLEEP;
     }
-    else if (enemy->is_moving && e->run.count > 0) {
-        current_texture = e->run.frames[e->current_run_frame];
+
+    int n = spatial_grid_query(&store->grid, &edge, store->awake, store->grid.capacity);
+    int kept = 0;
+    for (int k = 0; k < n; k++) {
+        int i = store->awake[k];
+        if (SDL_HasIntersection(&store->rect[i], &active)) store->activation[i] = ENEMY_ACTIVE;
+        else if (SDL_HasIntersection(&store->rect[i], &edge)) store->activation[i] = ENEMY_EDGE;
+        else continue;
+        store->awake[kept++] = i;
     }
-    else if (e->idle.count > 0) {
-        current_texture = e->idle.frames[e->current_idle_frame];
+    store->awake_count = kept;
+
+    // Ascending indices keep every type in one contiguous run
+    qsort(store->awake, kept, sizeof(int), enemy_cmp_index);
+}
+
+// Awake enemies are at most ENEMY_EDGE_MARGIN away from the view, so their clips are
+// hinted before the first draw; attack and death only play for enemies on screen
+static void enemies_prefetch_type(const EnemyStore *store, const int *ids, int n, const EnemyTypeInfo *type) {
+    texture_clip_prefetch(&type->idle);
+    texture_clip_prefetch(&type->run);
+    for (int k = 0; k < n; k++) {
+        if (store->activation[ids[k]] != ENEMY_ACTIVE) continue;
+        texture_clip_prefetch(&type->attack);
+        // Not drawn at QUALITY_NO_COSMETICS
+        if (!quality_at_least(QUALITY_NO_COSMETICS)) texture_clip_prefetch(&type->death);
+        break;
     }
+}
+
+// Eye height to the player centre through the solid bitset; only for players the enemy would react to
+static void enemy_update_sight(EnemyStore *store, int i, const EnemyTypeInfo *type, const Player *player, struct Map *map) {
+    const SDL_Rect *r = &store->rect[i];
+    const SDL_Rect *p = &player->entity.rect;
+    float eye_x = r->x + r->w / 2.0f;
+    float eye_y = r->y + r->h / 4.0f;
+    float target_x = p->x + p->w / 2.0f;
+    float target_y = p->y + p->h / 2.0f;
 
-    entity_render(renderer, e, current_texture, camera_x, camera_y);
+    int reach = type->detection_range;
+    if (type->attack_type == RANGED && RANGED_ATTACK_RANGE > reach) reach = RANGED_ATTACK_RANGE;
+
+    if (fabsf(target_x - eye_x) <= reach && map_line_of_sight(map, eye_x, eye_y, target_x, target_y))
+        store->flags[i] |= ENEMY_FLAG_SEES_PLAYER;
+    else
+        store->flags[i] &= (Uint8)~ENEMY_FLAG_SEES_PLAYER;
+}
 
-    // Health Bar
-    if (!e->is_dying && e->health > 0) {
-        int bar_x = (e->rect.x - e->offset_x + e->sprite_w / 2 - ENEMY_BAR_W / 2) - camera_x;
-        int bar_y = (e->rect.y - ENEMY_BAR_H - ENEMY_BAR_OFFSET_Y) - camera_y;
+// Heading towards the player along the nav graph: -1, +1 or 0 to stay. On the player's
+// span straight at it but never over the ends, elsewhere the flow link out of the span.
+// Where the player cannot be reached the enemy waits instead of walking into a pit.
+static int enemy_nav_direction(EnemyStore *store, int i, const NavGraph *nav, float diff_x, bool *jump) {
+    const SDL_Rect *r = &store->rect[i];
+    int want = diff_x > 0 ? 1 : -1;
+    *jump = false;
 
-        SDL_Rect bar_bg = {bar_x, bar_y, ENEMY_BAR_W, ENEMY_BAR_H};
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        SDL_RenderFillRect(renderer, &bar_bg);
+    // Map without walkable floor: chase while in sight
+    if (nav->span_count == 0) return (store->flags[i] & ENEMY_FLAG_SEES_PLAYER) ? want : 0;
 
-        float ratio = (float)e->health / (float)enemy->max_health;
-        SDL_Rect bar_hp = {bar_x, bar_y, (int)(ENEMY_BAR_W * ratio), ENEMY_BAR_H};
-        SDL_SetRenderDrawColor(renderer, 200, 0, 0, 255);
-        SDL_RenderFillRect(renderer, &bar_hp);
+    int center_x = r->x + r->w / 2;
+    int span = nav_span_under(nav, center_x, r->y + r->h);
+    if (span < 0) return store->nav_dir[i];
 
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderDrawRect(renderer, &bar_bg);
+    const NavSpan *s = &nav->spans[span];
+    int dir = 0;
+    if (span == nav->flow_goal) {
+        // Ledge check: the next step has to stay on the span
+        int next_tx = (center_x + want * 2) / nav->tile_size;
+        if (next_tx >= s->tx0 && next_tx <= s->tx1) dir = want;
+    } else {
+        const NavLink *link = nav_flow_link(nav, span);
+        if (link) {
+            dir = link->dir;
+            int end = dir > 0 ? s->tx1 : s->tx0;
+            *jump = link->type == NAV_JUMP && center_x / nav->tile_size == end;
+        }
     }
+    store->nav_dir[i] = (Sint8)dir;
+    return dir;
 }
 
-void enemy_update_animation(Enemy *enemy) {
-    Uint32 now = SDL_GetTicks();
+// AI, physics and animation for the awake enemies ids[0..n) of one type
+static void enemies_update_type(EnemyStore *store, const int *ids, int n, const EnemyTypeInfo *type,
+                                Player *player, struct Map *map, Uint32 now) {
+    float p_center_x = player->entity.rect.x + player->entity.rect.w / 2.0f;
+    bool halve_distant = quality_at_least(QUALITY_DISTANT_HALF_RATE);
+
+    for (int k = 0; k < n; k++) {
+        int i = ids[k];
+        bool on_screen = store->activation[i] == ENEMY_ACTIVE;
+
+        if (!on_screen) {
+            enemy_grunt_stop(store, i);
+            if ((now + i) % ENEMY_EDGE_TICK_DIV != 0) continue;
+        }
+
+        // 1. Death / Dying Check
+        if (store->flags[i] & ENEMY_FLAG_DYING) {
+            enemy_update_death(store, i, type, now);
+            continue;
+        }
+        if (store->flags[i] & ENEMY_FLAG_DEAD) continue;
+
+        // Grunt loops only while the enemy is on screen, the voice manager attenuates and caps it
+        if (on_screen && type->grunt.chunk) {
+            float src_x = store->rect[i].x + store->rect[i].w / 2.0f;
+            float src_y = store->rect[i].y + store->rect[i].h / 2.0f;
+            if (voice_is_playing(store->grunt_voice[i])) voice_set_position(store->grunt_voice[i], src_x, src_y);
+            else store->grunt_voice[i] = voice_play_at(&type->grunt, -1, src_x, src_y);
+        }
 
-    if (now < enemy->attack_timer_end) {
-        if (now - enemy->last_time >= ENEMY_ANIMATION_SPEED) {
-            enemy->entity.current_attack_frame++;
-            if (enemy->entity.current_attack_frame >= enemy->entity.attack.count) {
-                enemy->entity.current_attack_frame = 0;
+        // 2. AI LOGIC
+        if ((now + i) % ENEMY_SIGHT_TICKS == 0) enemy_update_sight(store, i, type, player, map);
+
+        SDL_Rect *rect = &store->rect[i];
+        float e_center_x = rect->x + rect->w / 2.0f;
+        float diff_x = p_center_x - e_center_x;
+        float distance = fabs(diff_x);
+
+        store->vel_x[i] = 0;
+        store->flags[i] &= (Uint8)~ENEMY_FLAG_MOVING;
+
+        // Follow the nav graph instead of walking straight through terrain or off ledges
+        int heading = 0;
+        if (now >= store->attack_timer_end[i] && distance < type->detection_range && distance > 5.0f) {
+            bool jump = false;
+            heading = enemy_nav_direction(store, i, &map->nav, diff_x, &jump);
+            if (heading != 0) {
+                store->vel_x[i] = heading * ENEMY_SPEED;
+                store->flags[i] |= ENEMY_FLAG_MOVING;
+            }
+            if (jump && (store->flags[i] & ENEMY_FLAG_ON_GROUND)) {
+                store->vel_y[i] = -ENEMY_JUMP_SPEED;
+                store->flags[i] &= (Uint8)~ENEMY_FLAG_ON_GROUND;
             }
-            enemy->last_time = now;
         }
-        return; 
+
+        // Face the way it walks, the player otherwise
+        bool face_right = (heading != 0 ? heading > 0 : diff_x > 0) != type->flip_inverted;
+        store->flip[i] = face_right ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
+
+        // 3. PHYSICS UPDATE
+        // Edge enemies catch up on the frames they skipped, so they walk and fall at full speed
+        int steps = on_screen ? 1 : ENEMY_EDGE_TICK_DIV;
+        float walk_x = store->vel_x[i];
+        int on_ground = (store->flags[i] & ENEMY_FLAG_ON_GROUND) != 0;
+        for (int step = 0; step < steps; step++) {
+            store->vel_x[i] = walk_x;
+            if (on_ground) store->vel_x[i] += enemy_separation(store, i);
+            entity_move_and_collide(rect, &store->vel_x[i], &store->vel_y[i], &on_ground, map, ENEMY_GRAVITY, ENEMY_MAX_FALL_SPEED);
+            spatial_grid_update(&store->grid, i, rect);
+        }
+        if (on_ground) store->flags[i] |= ENEMY_FLAG_ON_GROUND;
+        else store->flags[i] &= (Uint8)~ENEMY_FLAG_ON_GROUND;
+
+        // Death floor check
+        if (rect->y > 600) store->health[i] = 0;
+
+        // 4. ANIMATION (edge enemies are not drawn); under load distant ones step every other frame
+        bool distant = halve_distant && fabsf(rect->x + rect->w / 2.0f - p_center_x) > ENEMY_NEAR_RANGE;
+        if (on_screen && (!distant || (now + i) % 2 == 0)) enemy_update_animation(store, i, type, now);
     }
-    entity_update_animation(&enemy->entity, enemy->is_moving, ENEMY_ANIMATION_SPEED);
 }
 
-void enemy_decrease_health(Enemy *enemy, int amount) {
-    enemy->entity.health -= amount;
-    if (enemy->entity.health <= 0 && !enemy->entity.is_dying) {
-        enemy->entity.is_dying = 1;
-        enemy->entity.current_death_frame = 0;
-        enemy->entity.alpha = 255;
-        enemy->entity.vel_x = 0;
-        enemy->entity.vel_y = 0;
-    }
+typedef struct {
+    EnemyStore *store;
+    Player *player;
+    ProjectilePool *projectiles;
+    Uint32 now;
+} EnemyAttack;
+
+static bool enemy_attack_visit(void *ctx, int i) {
+    EnemyAttack *a = ctx;
+    EnemyStore *store = a->store;
+    if (store->health[i] <= 0) return true;
+    const EnemyTypeInfo *type = enemy_store_type(store, i);
+    if (type->attack_type == MELEE) melee_enemy_attack(store, i, type, a->player, a->now);
+    else ranged_enemy_attack(store, i, type, a->player, a->projectiles, a->now);
+    return true;
 }
 
-void enemy_handle_attack(Enemy *enemy, Player *player) {
-    if (enemy->entity.health <= 0) return;
+// Only enemies in the cells around the player can reach it
+static void enemies_attack_player(EnemyStore *store, Player *player, ProjectilePool *projectiles, Uint32 now) {
+    // Melee needs an overlap and shots fly level, so the reach bounds both axes
+    int reach = RANGED_ATTACK_RANGE > MELEE_ATTACK_RANGE ? RANGED_ATTACK_RANGE : MELEE_ATTACK_RANGE;
+    SDL_Rect area = {
+        player->entity.rect.x - reach, player->entity.rect.y - reach,
+        player->entity.rect.w + 2 * reach, player->entity.rect.h + 2 * reach
+    };
 
-    if (enemy->attack_type == MELEE) {
-        // Cast to Child meleeEnemy
-        MeleeEnemy *me = (MeleeEnemy *)enemy; 
-        if(melee_check_Player_in_range(me, player)) {
-            enemy_handle_melee_attack(me, player);
-        }
-    } 
-    else if (enemy->attack_type == RANGED) {
-        // Cast to Child rangedEnemy
-        RangedEnemy *re = (RangedEnemy *)enemy;
-        if(ranged_check_player_in_range(re, player)) {
-            enemy_handle_ranged_attack(re, player);
-        }
+    EnemyAttack attack = { store, player, projectiles, now };
+    spatial_grid_visit(&store->grid, &area, enemy_attack_visit, &attack);
+}
+
+void enemies_update(EnemyStore *store, Player *player, struct Map *map, const SDL_Rect *view, ProjectilePool *projectiles, Uint32 now) {
+    enemies_update_activation(store, view);
+
+    // One flow field towards the player's span for all enemies; in the air the last one stays
+    const SDL_Rect *p = &player->entity.rect;
+    nav_flow_update(&map->nav, nav_span_under(&map->nav, p->x + p->w / 2, p->y + p->h));
+
+    // One batched loop per type over its run in the awake list
+    int k = 0;
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        int end = store->type_begin[t] + store->type_count[t];
+        int first = k;
+        while (k < store->awake_count && store->awake[k] < end) k++;
+        if (k == first) continue;
+        enemies_prefetch_type(store, &store->awake[first], k - first, store->types[t]);
+        enemies_update_type(store, &store->awake[first], k - first, store->types[t], player, map, now);
     }
+
+    enemies_attack_player(store, player, projectiles, now);
 }
 
-void enemy_take_damage_from_player(Enemy *enemy, SDL_Rect player_attack_rect, int damage) {
+void enemies_render(RenderSnapshot *out, const EnemyStore *store, int camera_x, int camera_y, Uint32 now) {
+    bool health_bars = !quality_at_least(QUALITY_NO_HEALTH_BARS);
+    bool cosmetics = !quality_at_least(QUALITY_NO_COSMETICS);
+    int k = 0;
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        int end = store->type_begin[t] + store->type_count[t];
+        const EnemyTypeInfo *type = store->types[t];
+
+        // Only the awake list is walked, sleeping enemies cost nothing here
+        for (; k < store->awake_count && store->awake[k] < end; k++) {
+            int i = store->awake[k];
+            Uint8 flags = store->flags[i];
+            if (flags & ENEMY_FLAG_DEAD) continue;
+            if (store->activation[i] != ENEMY_ACTIVE) continue;
+            if ((flags & ENEMY_FLAG_DYING) && !cosmetics) continue;
+
+            const SpriteFrameArray *clip = NULL;
+            int frame = 0;
+            Uint8 alpha = 255;
+
+            if ((flags & ENEMY_FLAG_DYING) && type->death.count > 0) {
+                clip = &type->death;
+                frame = store->frame_death[i];
+                alpha = store->alpha[i];
+            }
+            else if (now < store->attack_timer_end[i] && type->attack.count > 0) {
+                clip = &type->attack;
+                frame = store->frame_attack[i];
+            }
+            else if ((flags & ENEMY_FLAG_MOVING) && type->run.count > 0) {
+                clip = &type->run;
+                frame = store->frame_run[i];
+            }
+            else if (type->idle.count > 0) {
+                clip = &type->idle;
+                frame = store->frame_idle[i];
+            }
+
+            if (clip) {
+                RenderItem *sprite = entity_draw_sprite(out, clip, frame, &store->rect[i], type->offset_x, type->offset_y,
+                                                        type->sprite_w, type->sprite_h, (SDL_RendererFlip)store->flip[i], camera_x, camera_y);
+                if (sprite) sprite->color.a = alpha;
+            }
 
-    if (enemy->entity.is_dead) return;
+            // Health Bar
+            if (health_bars && !(flags & ENEMY_FLAG_DYING) && store->health[i] > 0) {
+                int bar_x = (store->rect[i].x - type->offset_x + type->sprite_w / 2 - ENEMY_BAR_W / 2) - camera_x;
+                int bar_y = (store->rect[i].y - ENEMY_BAR_H - ENEMY_BAR_OFFSET_Y) - camera_y;
 
-    if (SDL_HasIntersection(&player_attack_rect, &enemy->entity.rect)) {
-        enemy->entity.health -= damage;
-        if (enemy->entity.health <= 0 && !enemy->entity.is_dying) {
-            enemy->entity.is_dying = 1;
-            enemy->entity.current_death_frame = 0;
-            enemy->entity.alpha = 255;
-            enemy->entity.vel_x = 0;
-            enemy->entity.vel_y = 0;
+                SDL_Rect bar_bg = {bar_x, bar_y, ENEMY_BAR_W, ENEMY_BAR_H};
+                render_snapshot_rect(out, &bar_bg, 50, 50, 50, true);
+
+                float ratio = (float)store->health[i] / (float)type->max_health;
+                SDL_Rect bar_hp = {bar_x, bar_y, (int)(ENEMY_BAR_W * ratio), ENEMY_BAR_H};
+                render_snapshot_rect(out, &bar_hp, 200, 0, 0, true);
+
+                render_snapshot_rect(out, &bar_bg, 255, 255, 255, false);
+            }
         }
     }
-}
\ No newline at end of file
+}
+
+void enemy_decrease_health(EnemyStore *store, int i, int amount) {
+    store->health[i] -= amount;
+    if (store->health[i] <= 0 && !(store->flags[i] & ENEMY_FLAG_DYING)) {
+        store->flags[i] |= ENEMY_FLAG_DYING;
+        store->frame_death[i] = 0;
+        store->alpha[i] = 255;
+        store->vel_x[i] = 0;
+        store->vel_y[i] = 0;
+    }
+}
+
+typedef struct {
+    EnemyStore *store;
+    const SDL_Rect *area;
+    int damage;
+} EnemyHit;
+
+static bool enemy_hit_visit(void *ctx, int i) {
+    EnemyHit *hit = ctx;
+    if (hit->store->flags[i] & ENEMY_FLAG_DEAD) return true;
+    if (SDL_HasIntersection(hit->area, &hit->store->rect[i])) enemy_decrease_health(hit->store, i, hit->damage);
+    return true;
+}
+
+void enemies_take_damage_from_player(EnemyStore *store, SDL_Rect player_attack_rect, int damage) {
+    if (player_attack_rect.w <= 0 || player_attack_rect.h <= 0) return;
+
+    EnemyHit hit = { store, &player_attack_rect, damage };
+    spatial_grid_visit(&store->grid, &player_attack_rect, enemy_hit_visit, &hit);
+}
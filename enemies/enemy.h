@@ -4,9 +4,13 @@
 #include <SDL.h>
 #include "../entity/entity.h" // Hier wird die Entity-Struktur eingebunden
 #include "../player/player.h" // Für die Player-Struktur
+#include "enemyStore.h"
+#include "projectile.h"
+#include "../bgm/voiceManager.h"
 
-#define ENEMY_ANIMATION_SPEED 150
+#define ENEMY_ANIMATION_SPEED 150 // ms
 #define ENEMY_SPEED 1.5f       // Langsamer als der Spieler (3.0f)
+#define ENEMY_JUMP_SPEED 6.5f  // clears NAV_JUMP_RISE rows (map/mapNav.h), player: 9.0f
 
 #define GRAVITY 0.4f
 #define MAX_FALL_SPEED 10.0f
@@ -15,34 +19,22 @@
 #define ENEMY_BAR_H 5
 #define ENEMY_BAR_OFFSET_Y 10
 
-typedef enum {
-    MELEE,
-    RANGED
-} AttackType; 
-
-typedef struct {
-    Entity entity;        // Alles aus Entity: rect, vel, frames, flip, on_ground, etc.
-    int is_moving;        // Laufstatus für Animation
-    int current_idle_frame;
-    int current_run_frame;
-    int current_attack_frame;
-    int spawn_x;         // Startposition X für Reset
-    int spawn_y;         // Startposition Y für Reset
-    Uint32 last_time;     // Zeitstempel für Animation
-    int max_health;       // Max HP für Health Bar Berechnung
-    int damage; 
-    int detection_range; // Wie weit sieht der Gegner den Spieler?
-    AttackType attack_type; // NEU: Angriffsart (Nahkampf oder Fernkampf)
-    Uint32 attack_timer_end;         
-} Enemy;
+// Activation regions around the camera view; streamed maps keep the edge region resident
+#define ENEMY_ACTIVE_MARGIN 64     // px beyond the view that still count as on screen
+#define ENEMY_EDGE_MARGIN 320      // px beyond the view that keep ticking slowly
+
+// Line of sight to the player is cast at most this often per enemy, staggered by index
+#define ENEMY_SIGHT_TICKS 8
+
+struct Map;
 
 // Funktionsprototypen
-void enemy_update_animation(Enemy *enemy);
-void enemy_update(Enemy *enemy, Player *player, struct Map *map);
-void enemy_decrease_health(Enemy *enemy, int amount);
-void enemy_render(SDL_Renderer *renderer, Enemy *enemy, int camera_x, int camera_y);
-void enemy_cleanup(Enemy *enemy);
-void enemy_handle_attack(Enemy *enemy, Player *player);
-void enemy_take_damage_from_player(Enemy *enemy, SDL_Rect attack_rect, int damage);
-
-#endif // ENEMY_H
\ No newline at end of file
+void enemy_type_set_hitbox(EnemyTypeInfo *type, float scale_w, float scale_h);
+// view is the camera rect in world pixels, it decides which enemies are awake; now is the FrameClock tick
+void enemies_update(EnemyStore *store, Player *player, struct Map *map, const SDL_Rect *view, ProjectilePool *projectiles, Uint32 now);
+// Records sprites and health bars of the active enemies into the render snapshot
+void enemies_render(struct RenderSnapshot *out, const EnemyStore *store, int camera_x, int camera_y, Uint32 now);
+void enemy_decrease_health(EnemyStore *store, int i, int amount);
+void enemies_take_damage_from_player(EnemyStore *store, SDL_Rect attack_rect, int damage);
+
+#endif // ENEMY_H
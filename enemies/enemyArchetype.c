@@ -0,0 +1,210 @@
+#include "enemyArchetype.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "enemy.h"
+#include "../entity/entity.h"
+#include "../assets/assetPack.h"
+#include "../memory/memTrack.h"
+
+extern void debug_log(const char *format, ...);
+
+#define ENEMY_ARCHETYPE_PATH_MAX 128
+
+/*
+ * One [section] of the manifest. The parser fills the stats of proto and
+ * remembers the asset paths; frames and sounds are set up the first time a
+ * level spawns the type and then stay for the whole session. Animation
+ * textures are lazy clips (texture/textureResidency.h): loaded when the type
+ * wakes up near the view, evicted again under budget pressure.
+ */
+typedef struct {
+    char name[ENEMY_ARCHETYPE_NAME_MAX];
+    int spawn_shape;
+    float hitbox_scale_w, hitbox_scale_h;
+    float projectile_scale;
+    char idle[ENEMY_ARCHETYPE_PATH_MAX];
+    char run[ENEMY_ARCHETYPE_PATH_MAX];
+    char attack[ENEMY_ARCHETYPE_PATH_MAX];
+    char death[ENEMY_ARCHETYPE_PATH_MAX];
+    char projectile[ENEMY_ARCHETYPE_PATH_MAX];
+    char grunt[ENEMY_ARCHETYPE_PATH_MAX];
+    int grunt_instances;
+    int grunt_volume;
+    EnemyTypeInfo proto;
+} EnemyArchetype;
+
+static EnemyArchetype g_archetypes[ENEMY_TYPE_MAX];
+static int g_archetype_count = 0;
+static bool g_archetypes_parsed = false;
+
+static char *archetype_trim(char *s) {
+    while (*s == ' ' || *s == '\t') s++;
+    char *end = s + strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+    return s;
+}
+
+static void archetype_set_path(char *dst, const char *value) {
+    snprintf(dst, ENEMY_ARCHETYPE_PATH_MAX, "%s", value);
+}
+
+static void archetype_parse_key(EnemyArchetype *a, const char *key, const char *value) {
+    EnemyTypeInfo *t = &a->proto;
+
+    if (strcmp(key, "spawn_shape") == 0) a->spawn_shape = atoi(value);
+    else if (strcmp(key, "attack") == 0) t->attack_type = strcmp(value, "ranged") == 0 ? RANGED : MELEE;
+    else if (strcmp(key, "health") == 0) t->max_health = atoi(value);
+    else if (strcmp(key, "damage") == 0) t->damage = atoi(value);
+    else if (strcmp(key, "detection_range") == 0) t->detection_range = atoi(value);
+    else if (strcmp(key, "flip_inverted") == 0) t->flip_inverted = atoi(value) != 0;
+    else if (strcmp(key, "hitbox_scale") == 0) sscanf(value, "%f %f", &a->hitbox_scale_w, &a->hitbox_scale_h);
+    else if (strcmp(key, "idle") == 0) archetype_set_path(a->idle, value);
+    else if (strcmp(key, "run") == 0) archetype_set_path(a->run, value);
+    else if (strcmp(key, "attack_frames") == 0) archetype_set_path(a->attack, value);
+    else if (strcmp(key, "death") == 0) archetype_set_path(a->death, value);
+    else if (strcmp(key, "projectile") == 0) archetype_set_path(a->projectile, value);
+    else if (strcmp(key, "projectile_scale") == 0) a->projectile_scale = (float)atof(value);
+    else if (strcmp(key, "projectile_velocity") == 0) sscanf(value, "%f %f", &t->proj_vel_x, &t->proj_vel_y);
+    else if (strcmp(key, "projectile_damage") == 0) t->proj_damage = atoi(value);
+    else if (strcmp(key, "cooldown_ms") == 0) t->cooldown_ms = atoi(value);
+    else if (strcmp(key, "grunt") == 0) {
+        sscanf(value, "%127s %d %d", a->grunt, &a->grunt_instances, &a->grunt_volume);
+    }
+    else debug_log("ENEMY_ARCHETYPE: Unbekannter Schluessel '%s' in [%s]", key, a->name);
+}
+
+bool enemy_archetypes_load(const char *manifest_path) {
+    if (g_archetypes_parsed) return g_archetype_count > 0;
+    g_archetypes_parsed = true;
+    g_archetype_count = 0;
+
+    SDL_RWops *rw = asset_open(manifest_path);
+    Sint64 size = rw ? SDL_RWsize(rw) : -1;
+    char *text = size >= 0 ? mem_alloc(MEM_TAG_ASSETS, (size_t)size + 1) : NULL;
+    if (!text || SDL_RWread(rw, text, 1, (size_t)size) != (size_t)size) {
+        debug_log("ENEMY_ARCHETYPE: Kein Manifest %s, keine Gegner", manifest_path);
+        mem_free(text);
+        if (rw) SDL_RWclose(rw);
+        return false;
+    }
+    SDL_RWclose(rw);
+    text[size] = '\0';
+
+    EnemyArchetype *current = NULL;
+    for (char *line = strtok(text, "\r\n"); line; line = strtok(NULL, "\r\n")) {
+        line = archetype_trim(line);
+        if (line[0] == '#' || line[0] == '\0') continue;
+
+        if (line[0] == '[') {
+            char *close = strchr(line, ']');
+            if (!close) continue;
+            if (g_archetype_count >= ENEMY_TYPE_MAX) {
+                debug_log("ENEMY_ARCHETYPE: Mehr als %d Typen, Rest ignoriert", ENEMY_TYPE_MAX);
+                current = NULL;
+                break;
+            }
+            *close = '\0';
+            current = &g_archetypes[g_archetype_count++];
+            memset(current, 0, sizeof(*current));
+            snprintf(current->name, sizeof(current->name), "%s", line + 1);
+            current->spawn_shape = -1;
+            current->hitbox_scale_w = 1.0f;
+            current->hitbox_scale_h = 1.0f;
+            current->projectile_scale = 1.0f;
+            current->grunt_instances = 1;
+            current->grunt_volume = MIX_MAX_VOLUME;
+            continue;
+        }
+
+        char *eq = strchr(line, '=');
+        if (!current || !eq) continue;
+        *eq = '\0';
+        archetype_parse_key(current, archetype_trim(line), archetype_trim(eq + 1));
+    }
+    mem_free(text);
+
+    debug_log("ENEMY_ARCHETYPE: %d Typen aus %s", g_archetype_count, manifest_path);
+    return g_archetype_count > 0;
+}
+
+int enemy_archetype_count(void) {
+    enemy_archetypes_load(ENEMY_ARCHETYPE_MANIFEST);
+    return g_archetype_count;
+}
+
+const char *enemy_archetype_name(int type) {
+    if (type < 0 || type >= g_archetype_count) return "?";
+    return g_archetypes[type].name;
+}
+
+int enemy_archetype_for_shape(int shape) {
+    enemy_archetypes_load(ENEMY_ARCHETYPE_MANIFEST);
+    for (int t = 0; t < g_archetype_count; t++) {
+        if (g_archetypes[t].spawn_shape == shape) return t;
+    }
+    return -1;
+}
+
+// Paths ending in .png are a single frame, everything else is a numbered sequence.
+// Animations are registered as lazy clips, projectiles are drawn from the pool and loaded up front
+static void archetype_load_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char *path, bool lazy) {
+    size_t len = strlen(path);
+    if (len == 0) return;
+    bool single = len > 4 && strcmp(path + len - 4, ".png") == 0;
+    if (lazy) {
+        if (single) entity_register_frame(renderer, out, path);
+        else entity_register_frames(renderer, out, path);
+    } else {
+        if (single) entity_load_frame(renderer, out, path);
+        else entity_load_frames(renderer, out, path);
+    }
+}
+
+const EnemyTypeInfo *enemy_archetype_get(int type, SDL_Renderer *renderer) {
+    enemy_archetypes_load(ENEMY_ARCHETYPE_MANIFEST);
+    if (type < 0 || type >= g_archetype_count) return NULL;
+
+    EnemyArchetype *a = &g_archetypes[type];
+    EnemyTypeInfo *t = &a->proto;
+    if (t->loaded) return t;
+
+    archetype_load_frames(renderer, &t->idle, a->idle, true);
+    archetype_load_frames(renderer, &t->run, a->run, true);
+    archetype_load_frames(renderer, &t->attack, a->attack, true);
+    archetype_load_frames(renderer, &t->death, a->death, true);
+    archetype_load_frames(renderer, &t->projectile, a->projectile, false);
+    enemy_type_set_hitbox(t, a->hitbox_scale_w, a->hitbox_scale_h);
+
+    if (a->projectile[0]) {
+        if (t->projectile.count == 0) {
+            debug_log("ENEMY_ARCHETYPE: Keine Projektil-Frames unter %s", a->projectile);
+        } else {
+            t->projectile_w = (int)(t->projectile.sprite_w * a->projectile_scale);
+            t->projectile_h = (int)(t->projectile.sprite_h * a->projectile_scale);
+        }
+    }
+    if (a->grunt[0]) {
+        t->grunt = (VoiceSound){ sfx_load(a->grunt), VOICE_PRIORITY_ENEMY,
+                                 (Uint8)a->grunt_instances, (Uint8)a->grunt_volume };
+    }
+
+    t->loaded = true;
+    debug_log("ENEMY_ARCHETYPE: %s geladen (Hitbox %dx%d)", a->name, t->hitbox_w, t->hitbox_h);
+    return t;
+}
+
+void enemy_archetypes_cleanup(void) {
+    for (int i = 0; i < g_archetype_count; i++) {
+        EnemyTypeInfo *t = &g_archetypes[i].proto;
+        if (!t->loaded) continue;
+        entity_free_frames(&t->idle);
+        entity_free_frames(&t->run);
+        entity_free_frames(&t->attack);
+        entity_free_frames(&t->death);
+        entity_free_frames(&t->projectile);
+        sfx_cleanup(t->grunt.chunk);
+        t->grunt.chunk = NULL;
+        t->loaded = false;
+    }
+}
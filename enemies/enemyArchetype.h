@@ -0,0 +1,23 @@
+#ifndef ENEMY_ARCHETYPE_H
+#define ENEMY_ARCHETYPE_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "enemyStore.h"
+
+// Stats, frames and sounds of every enemy type; new types only need an entry here and a spawn shape
+#define ENEMY_ARCHETYPE_MANIFEST "resources/enemies.cfg"
+#define ENEMY_ARCHETYPE_NAME_MAX 24
+
+// Parses the manifest once per session (no assets yet), called on first use
+bool enemy_archetypes_load(const char *manifest_path);
+int enemy_archetype_count(void);
+const char *enemy_archetype_name(int type);
+// Type id spawned by a collision tile shape, -1 = none
+int enemy_archetype_for_shape(int shape);
+// Prototype of the type; clips are registered and sounds loaded on the first call, kept until cleanup
+const EnemyTypeInfo *enemy_archetype_get(int type, SDL_Renderer *renderer);
+// Frees every loaded prototype, before the renderer and the mixer go away
+void enemy_archetypes_cleanup(void);
+
+#endif
@@ -0,0 +1,154 @@
+#include "enemyStore.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../memory/arena.h"
+#include "enemyArchetype.h"
+
+extern void debug_log(const char *format, ...);
+
+#define STORE_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+// Carves every array out of one block. With base == NULL only the size is computed.
+static size_t enemy_store_layout(EnemyStore *store, Uint8 *base, int n) {
+    size_t off = 0;
+#define CARVE(field, elems) do { \
+        if (base) store->field = (void *)(base + off); \
+        off += STORE_ALIGN(sizeof(*store->field) * (size_t)(elems)); \
+    } while (0)
+
+    // hot
+    CARVE(rect, n);
+    CARVE(vel_x, n);
+    CARVE(vel_y, n);
+    CARVE(health, n);
+    CARVE(flags, n);
+    CARVE(flip, n);
+    CARVE(attack_timer_end, n);
+    CARVE(shoot_cooldown_end, n);
+    CARVE(activation, n);
+    CARVE(nav_dir, n);
+    // warm
+    CARVE(anim_time, n);
+    CARVE(frame_idle, n);
+    CARVE(frame_run, n);
+    CARVE(frame_attack, n);
+    CARVE(frame_death, n);
+    CARVE(alpha, n);
+    // cold
+    CARVE(type, n);
+    CARVE(spawn, n);
+    CARVE(grunt_voice, n);
+    CARVE(projectiles_live, n);
+    CARVE(awake, n);
+#undef CARVE
+    return off;
+}
+
+bool enemy_store_init(EnemyStore *store, const int type_counts[ENEMY_TYPE_MAX], int world_w, int world_h, Arena *arena) {
+    memset(store, 0, sizeof(*store));
+    store->arena = arena;
+
+    int total = 0;
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        store->type_begin[t] = total;
+        store->type_capacity[t] = type_counts[t];
+        total += type_counts[t];
+    }
+    if (total == 0) return true;
+
+    size_t size = enemy_store_layout(store, NULL, total);
+    store->block = arena ? arena_alloc(arena, MEM_TAG_ENEMIES, size) : mem_alloc(MEM_TAG_ENEMIES, size);
+    if (!store->block) {
+        debug_log("ENEMY_STORE: Kein Speicher fuer %d Enemies (%u Bytes)", total, (unsigned)size);
+        memset(store->type_capacity, 0, sizeof(store->type_capacity));
+        return false;
+    }
+    memset(store->block, 0, size);
+    store->block_size = size;
+    store->capacity = total;
+    enemy_store_layout(store, store->block, total);
+    if (!spatial_grid_init(&store->grid, total, world_w, world_h, SPATIAL_GRID_CELL, arena)) {
+        memset(store->type_capacity, 0, sizeof(store->type_capacity));
+        return false;
+    }
+    debug_log("ENEMY_STORE: %d Enemies reserviert (%u Bytes)", total, (unsigned)size);
+    return true;
+}
+
+void enemy_store_load_types(EnemyStore *store, SDL_Renderer *renderer) {
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        // Typen ohne Spawn werden gar nicht erst geladen
+        if (store->type_capacity[t] == 0) continue;
+        store->types[t] = enemy_archetype_get(t, renderer);
+        // Unknown type: no spawns instead of a NULL prototype
+        if (!store->types[t]) store->type_capacity[t] = 0;
+    }
+}
+
+// Spawn state of slot i at its spawn point
+static void enemy_store_reset_slot(EnemyStore *store, int i, int type, const EnemyTypeInfo *info) {
+    store->rect[i].x = store->spawn[i].x;
+    store->rect[i].y = store->spawn[i].y;
+    store->vel_x[i] = 0;
+    store->vel_y[i] = 0;
+    store->health[i] = info->max_health;
+    store->flags[i] = 0;
+    store->flip[i] = SDL_FLIP_NONE;
+    store->attack_timer_end[i] = 0;
+    store->shoot_cooldown_end[i] = 0;
+    store->activation[i] = ENEMY_ASLEEP;
+    store->nav_dir[i] = 0;
+    store->anim_time[i] = 0;
+    store->frame_idle[i] = 0;
+    store->frame_run[i] = 0;
+    store->frame_attack[i] = 0;
+    store->frame_death[i] = 0;
+    store->alpha[i] = 255;
+    store->type[i] = (Uint8)type;
+    store->grunt_voice[i] = -1;
+    store->projectiles_live[i] = 0;
+    // Re-links an enemy that is still in the grid, files a removed (dead) one again
+    spatial_grid_insert(&store->grid, i, &store->rect[i]);
+}
+
+int enemy_store_spawn(EnemyStore *store, int type, int world_x, int world_y) {
+    if (type < 0 || type >= ENEMY_TYPE_MAX || store->type_count[type] >= store->type_capacity[type]) return -1;
+    const EnemyTypeInfo *info = store->types[type];
+
+    int i = store->type_begin[type] + store->type_count[type]++;
+    store->count++;
+
+    // Stand on the spawn tile
+    store->rect[i] = (SDL_Rect){ world_x, (world_y + 16) - info->hitbox_h - 2, info->hitbox_w, info->hitbox_h };
+    store->spawn[i] = (SDL_Point){ store->rect[i].x, store->rect[i].y };
+    enemy_store_reset_slot(store, i, type, info);
+    return i;
+}
+
+void enemy_store_reset(EnemyStore *store) {
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        int end = store->type_begin[t] + store->type_count[t];
+        for (int i = store->type_begin[t]; i < end; i++) {
+            enemy_store_reset_slot(store, i, t, store->types[t]);
+        }
+    }
+    // Every enemy is asleep again, the next activation pass wakes the ones near the view
+    store->awake_count = 0;
+}
+
+bool enemy_store_all_dead(const EnemyStore *store) {
+    for (int t = 0; t < ENEMY_TYPE_MAX; t++) {
+        int end = store->type_begin[t] + store->type_count[t];
+        for (int i = store->type_begin[t]; i < end; i++) {
+            if (!(store->flags[i] & ENEMY_FLAG_DEAD)) return false;
+        }
+    }
+    return true;
+}
+
+// Prototypes belong to the archetype registry and outlive the level
+void enemy_store_cleanup(EnemyStore *store) {
+    spatial_grid_cleanup(&store->grid);
+    if (!store->arena) mem_free(store->block);
+    memset(store, 0, sizeof(*store));
+}
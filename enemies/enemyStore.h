@@ -0,0 +1,130 @@
+#ifndef ENEMY_STORE_H
+#define ENEMY_STORE_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "../entity/spriteFramesArray.h"
+#include "../bgm/bgmHandler.h"
+#include "../bgm/voiceManager.h"
+#include "../entity/spatialGrid.h"
+
+struct Arena;
+
+#define MAX_PROJECTILES 2 // amount of projectiles a ranged enemy can have in the pool at once
+
+typedef enum {
+    MELEE,
+    RANGED
+} AttackType;
+
+// Type ids are archetype indices from enemies/enemyArchetype.c
+#define ENEMY_TYPE_MAX 8
+
+// State flags (hot)
+#define ENEMY_FLAG_ON_GROUND 0x01
+#define ENEMY_FLAG_MOVING    0x02
+#define ENEMY_FLAG_DYING     0x04
+#define ENEMY_FLAG_DEAD      0x08
+#define ENEMY_FLAG_HAS_FIRED 0x10 // ranged: projectile of the current attack animation is out
+#define ENEMY_FLAG_SEES_PLAYER 0x20 // cached line of sight, refreshed every ENEMY_SIGHT_TICKS
+
+// Activation by distance to the camera view (hot)
+#define ENEMY_ASLEEP 0   // far away: untouched until the player comes back
+#define ENEMY_EDGE   1   // just outside the view: simulated at a reduced rate, not drawn
+#define ENEMY_ACTIVE 2   // on or near the screen: full update, render and audio
+
+// Cold: stats and assets, shared by every enemy of one type (the archetype prototype)
+typedef struct {
+    bool loaded;
+    AttackType attack_type;
+    int max_health;
+    int damage;
+    int detection_range;   // Wie weit sieht der Gegner den Spieler?
+    bool flip_inverted;    // ShurikenDude frames face the other way
+
+    int sprite_w, sprite_h;
+    int hitbox_w, hitbox_h;
+    int offset_x, offset_y;
+
+    SpriteFrameArray idle;
+    SpriteFrameArray run;
+    SpriteFrameArray attack;
+    SpriteFrameArray death;
+    VoiceSound grunt;      // chunk NULL = silent type
+
+    // Ranged only
+    SpriteFrameArray projectile;
+    int projectile_w, projectile_h;
+    float proj_vel_x, proj_vel_y;
+    int proj_damage;
+    int cooldown_ms; // time between shots in milliseconds (converted with FRAME_TICKS)
+} EnemyTypeInfo;
+
+/*
+ * Struct-of-arrays storage for all enemies of a level.
+ * Enemies are grouped by type: type t occupies [type_begin[t], type_begin[t] + type_count[t]),
+ * so every type is updated in its own tight loop. All arrays live in one allocation,
+ * hot simulation arrays first.
+ */
+typedef struct EnemyStore {
+    int count;
+    int capacity;                      // slots carved out of block, also of types dropped at load
+    int type_begin[ENEMY_TYPE_MAX];
+    int type_count[ENEMY_TYPE_MAX];    // spawned so far
+    int type_capacity[ENEMY_TYPE_MAX]; // reserved by enemy_store_init
+
+    // --- hot: read/written every tick ---
+    SDL_Rect *rect;
+    float *vel_x;
+    float *vel_y;
+    int *health;
+    Uint8 *flags;
+    Uint8 *flip;               // SDL_RendererFlip
+    Uint32 *attack_timer_end;  // FrameClock ticks
+    Uint32 *shoot_cooldown_end;
+    Uint8 *activation;         // ENEMY_ASLEEP / ENEMY_EDGE / ENEMY_ACTIVE
+    Sint8 *nav_dir;            // heading along the nav graph, kept while in the air
+
+    // --- warm: animation bookkeeping ---
+    Uint32 *anim_time;
+    Uint8 *frame_idle;
+    Uint8 *frame_run;
+    Uint8 *frame_attack;
+    Uint8 *frame_death;
+    Uint8 *alpha;
+
+    // --- cold: per instance, touched on spawn / reset / rarely ---
+    Uint8 *type;
+    SDL_Point *spawn;
+    VoiceHandle *grunt_voice;
+    Uint8 *projectiles_live;   // shots of this enemy still in the projectile pool
+
+    SpatialGrid grid;          // broadphase over rect, indexed like the arrays
+
+    // Awake enemies of the current frame, ascending so types stay grouped
+    int *awake;
+    int awake_count;
+
+    void *block;
+    size_t block_size;
+    struct Arena *arena;       // owner of block, NULL = malloc
+
+    const EnemyTypeInfo *types[ENEMY_TYPE_MAX]; // session-owned archetypes, NULL = no spawn
+    int projectile_kind[ENEMY_TYPE_MAX];        // id in the level projectile pool, -1 = none
+} EnemyStore;
+
+// Reserves contiguous ranges for the given per-type counts and a grid over the world (arena may be NULL)
+bool enemy_store_init(EnemyStore *store, const int type_counts[ENEMY_TYPE_MAX], int world_w, int world_h, struct Arena *arena);
+// Binds the archetype of every type that has at least one enemy (assets load once per session)
+void enemy_store_load_types(EnemyStore *store, SDL_Renderer *renderer);
+// Places an enemy of the given type standing on the tile at (world_x, world_y), returns its index or -1
+int enemy_store_spawn(EnemyStore *store, int type, int world_x, int world_y);
+void enemy_store_reset(EnemyStore *store);
+bool enemy_store_all_dead(const EnemyStore *store);
+void enemy_store_cleanup(EnemyStore *store);
+
+static inline const EnemyTypeInfo *enemy_store_type(const EnemyStore *store, int i) {
+    return store->types[store->type[i]];
+}
+
+#endif
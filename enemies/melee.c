@@ -1,25 +1,24 @@
 #include "melee.h"
+#include <math.h>
 
-bool melee_check_Player_in_range(MeleeEnemy *enemy, Player *player) {
+bool melee_check_player_in_range(const SDL_Rect *enemy_rect, Player *player) {
     float p_center_x = player->entity.rect.x + player->entity.rect.w / 2.0f;
-    float e_center_x = enemy->base.entity.rect.x + enemy->base.entity.rect.w / 2.0f;
+    float e_center_x = enemy_rect->x + enemy_rect->w / 2.0f;
     float distance = fabs(p_center_x - e_center_x);
 
     return distance <= MELEE_ATTACK_RANGE;
 }
 
-void enemy_handle_melee_attack(MeleeEnemy *enemy, Player *player) {
-    if (enemy->base.entity.health <= 0) return;
-
+static void enemy_handle_melee_attack(const SDL_Rect *enemy_rect, int damage, Player *player, Uint32 now) {
     // Hitbox Adjustment
-    SDL_Rect enemy_hitbox = enemy->base.entity.rect;
+    SDL_Rect enemy_hitbox = *enemy_rect;
     enemy_hitbox.x += 4; enemy_hitbox.w -= 8;
     enemy_hitbox.y += 4; enemy_hitbox.h -= 8;
 
     // Attack Player
     if (SDL_HasIntersection(&player->entity.rect, &enemy_hitbox)) {
         int old_health = player->entity.health;
-        player_decrease_health(player, enemy->base.damage);
+        player_decrease_health(player, damage, now);
 
         // --- FIXED PUSHBACK ---
         float player_center_x = player->entity.rect.x + (player->entity.rect.w / 2.0f);
@@ -35,4 +34,10 @@ void enemy_handle_melee_attack(MeleeEnemy *enemy, Player *player) {
 
         if (player->entity.health < old_health) player->entity.vel_y = -4.0f;
     }
-}
\ No newline at end of file
+}
+
+void melee_enemy_attack(EnemyStore *store, int i, const EnemyTypeInfo *type, Player *player, Uint32 now) {
+    if (melee_check_player_in_range(&store->rect[i], player)) {
+        enemy_handle_melee_attack(&store->rect[i], type->damage, player, now);
+    }
+}
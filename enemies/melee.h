@@ -6,11 +6,8 @@
 #define MELEE_DETECTION_RANGE 250 
 #define MELEE_ATTACK_RANGE 25
 
-typedef struct {
-    Enemy base;
-} MeleeEnemy;
+bool melee_check_player_in_range(const SDL_Rect *enemy_rect, Player *player);
+// Candidate i comes from the grid query around the player
+void melee_enemy_attack(EnemyStore *store, int i, const EnemyTypeInfo *type, Player *player, Uint32 now);
 
-bool melee_check_Player_in_range(MeleeEnemy *enemy, Player *player);
-void enemy_handle_melee_attack(MeleeEnemy *enemy, Player *player);
-
-#endif
\ No newline at end of file
+#endif
@@ -1,46 +1,179 @@
 #include "projectile.h"
-#include "ranged.h"
+#include <stdlib.h>
+#include <string.h>
+#include "enemy.h"
+#include "../map/map.h"
+#include "../memory/arena.h"
+#include "../render/renderSnapshot.h"
 
-// fires a projectile -> either hits player or goes offscreen -> set used slot back to usable
-void projectiles_update(Projectile projectiles[], Player *player) {
-    for (int i = 0; i < MAX_PROJECTILES; i++) {
-        if (!projectiles[i].active) continue;
+extern void debug_log(const char *format, ...);
 
-        projectiles[i].x += projectiles[i].vel_x;
-        projectiles[i].y += projectiles[i].vel_y;
+#define POOL_ALIGN(n) (((n) + 7) & ~(size_t)7)
 
-        projectiles[i].rect.x = (int)projectiles[i].x;
-        projectiles[i].rect.y = (int)projectiles[i].y;
+// Same single-block layout as the enemy store, base == NULL only measures
+static size_t projectile_pool_layout(ProjectilePool *pool, Uint8 *base, int n) {
+    size_t off = 0;
+#define CARVE(field) do { \
+        if (base) pool->field = (void *)(base + off); \
+        off += POOL_ALIGN(sizeof(*pool->field) * (size_t)n); \
+    } while (0)
 
-        if (SDL_HasIntersection(&projectiles[i].rect, &player->entity.rect)) {
-            player_decrease_health(player, projectiles[i].damage);
-            projectiles[i].active = false;
-            continue;
-        }
+    CARVE(x);
+    CARVE(y);
+    CARVE(vel_x);
+    CARVE(vel_y);
+    CARVE(damage);
+    CARVE(owner);
+    CARVE(kind);
+    CARVE(team);
+#undef CARVE
+    return off;
+}
+
+bool projectile_pool_init(ProjectilePool *pool, int capacity, int world_w, int world_h, Arena *arena) {
+    memset(pool, 0, sizeof(*pool));
+    pool->world_w = world_w;
+    pool->world_h = world_h;
+
+    size_t size = projectile_pool_layout(pool, NULL, capacity);
+    void *block = arena ? arena_alloc(arena, MEM_TAG_ENEMIES, size) : mem_alloc(MEM_TAG_ENEMIES, size);
+    if (!block) {
+        debug_log("PROJECTILES: Kein Speicher fuer %d Projektile", capacity);
+        return false;
+    }
+    projectile_pool_layout(pool, block, capacity);
+    pool->capacity = capacity;
+    pool->block_size = size;
+    pool->arena_owned = arena != NULL;
+    debug_log("PROJECTILES: Pool fuer %d Projektile (%u Bytes)", capacity, (unsigned)size);
+    return true;
+}
+
+int projectile_pool_add_kind(ProjectilePool *pool, const SpriteFrameArray *sprite, int w, int h) {
+    if (pool->kind_count >= PROJECTILE_MAX_KINDS) return -1;
+    ProjectileKind *kind = &pool->kinds[pool->kind_count];
+    kind->sprite = sprite;
+    kind->w = w;
+    kind->h = h;
+    return pool->kind_count++;
+}
+
+bool projectile_spawn(ProjectilePool *pool, int kind, int team, int owner, float x, float y, float vel_x, float vel_y, int damage) {
+    if (pool->count >= pool->capacity || kind < 0 || kind >= pool->kind_count) return false;
+    int i = pool->count++;
+    pool->x[i] = x;
+    pool->y[i] = y;
+    pool->vel_x[i] = vel_x;
+    pool->vel_y[i] = vel_y;
+    pool->damage[i] = damage;
+    pool->owner[i] = (Sint16)owner;
+    pool->kind[i] = (Uint8)kind;
+    pool->team[i] = (Uint8)team;
+    return true;
+}
+
+static void projectile_expire(ProjectilePool *pool, int i, struct EnemyStore *enemies) {
+    // hand the shooter its slot back
+    int owner = pool->owner[i];
+    if (owner >= 0 && enemies && enemies->projectiles_live && enemies->projectiles_live[owner] > 0) {
+        enemies->projectiles_live[owner]--;
+    }
+
+    int last = --pool->count;
+    if (i == last) return;
+    pool->x[i] = pool->x[last];
+    pool->y[i] = pool->y[last];
+    pool->vel_x[i] = pool->vel_x[last];
+    pool->vel_y[i] = pool->vel_y[last];
+    pool->damage[i] = pool->damage[last];
+    pool->owner[i] = pool->owner[last];
+    pool->kind[i] = pool->kind[last];
+    pool->team[i] = pool->team[last];
+}
+
+typedef struct {
+    struct EnemyStore *enemies;
+    const SDL_Rect *rect;
+    int damage;
+    bool hit;
+} ProjectileHit;
 
-        if (projectiles[i].x < 0 || projectiles[i].x > 2000) { 
-            projectiles[i].active = false;
-            continue;
+static bool projectile_hit_visit(void *ctx, int e) {
+    ProjectileHit *h = ctx;
+    if (h->enemies->flags[e] & (ENEMY_FLAG_DYING | ENEMY_FLAG_DEAD)) return true;
+    if (!SDL_HasIntersection(h->rect, &h->enemies->rect[e])) return true;
+    enemy_decrease_health(h->enemies, e, h->damage);
+    h->hit = true;
+    return false;
+}
+
+// Player projectiles check the enemies in the grid cells around them
+static bool projectile_hit_enemy(struct EnemyStore *enemies, const SDL_Rect *rect, int damage) {
+    ProjectileHit h = { enemies, rect, damage, false };
+    spatial_grid_visit(&enemies->grid, rect, projectile_hit_visit, &h);
+    return h.hit;
+}
+
+void projectiles_update(ProjectilePool *pool, Player *player, struct EnemyStore *enemies, struct Map *map, Uint32 now) {
+    int i = 0;
+    while (i < pool->count) {
+        pool->x[i] += pool->vel_x[i];
+        pool->y[i] += pool->vel_y[i];
+
+        const ProjectileKind *kind = &pool->kinds[pool->kind[i]];
+        SDL_Rect rect = { (int)pool->x[i], (int)pool->y[i], kind->w, kind->h };
+        int center_x = rect.x + rect.w / 2;
+        int center_y = rect.y + rect.h / 2;
+
+        bool expired = false;
+        if (rect.x + rect.w < 0 || rect.x > pool->world_w || rect.y + rect.h < 0 || rect.y > pool->world_h) {
+            expired = true;
+        } else if (map_point_blocked(map, center_x, center_y)) {
+            expired = true;
+        } else if (pool->team[i] == PROJECTILE_TEAM_ENEMY) {
+            if (SDL_HasIntersection(&rect, &player->entity.rect)) {
+                if (pool->damage[i] > 0) player_decrease_health(player, pool->damage[i], now);
+                expired = true;
+            }
+        } else if (enemies) {
+            expired = projectile_hit_enemy(enemies, &rect, pool->damage[i]);
         }
+
+        // the swapped-in projectile is processed in the same slot
+        if (expired) projectile_expire(pool, i, enemies);
+        else i++;
     }
 }
 
-void projectiles_render(SDL_Renderer *renderer, Projectile projectiles[], int camera_x, int camera_y) {
-    for (int i = 0; i < MAX_PROJECTILES; i++) {
-        // check all projectiles if in active use -> render them
-        if (!projectiles[i].active) continue;
-        Projectile *p = &projectiles[i];
-
-        if (p->sprite.count > 0) {
-            int frame_idx = (SDL_GetTicks() / 100) % p->sprite.count;
-            SDL_Texture *current_frame = p->sprite.frames[frame_idx];
-            SDL_Rect dst = { 
-                p->rect.x - camera_x, 
-                p->rect.y - camera_y, 
-                p->rect.w, 
-                p->rect.h 
+void projectiles_render(RenderSnapshot *out, const ProjectilePool *pool, int camera_x, int camera_y, int view_w, int view_h, Uint32 now) {
+    Uint32 anim = now / FRAME_TICKS(100);
+
+    for (int k = 0; k < pool->kind_count; k++) {
+        const ProjectileKind *kind = &pool->kinds[k];
+        if (!kind->sprite || kind->sprite->count <= 0) continue;
+        SDL_Texture *current_frame = kind->sprite->frames[anim % kind->sprite->count];
+
+        for (int i = 0; i < pool->count; i++) {
+            if (pool->kind[i] != k) continue;
+            SDL_Rect dst = {
+                (int)pool->x[i] - camera_x,
+                (int)pool->y[i] - camera_y,
+                kind->w,
+                kind->h
             };
-            SDL_RenderCopy(renderer, current_frame, NULL, &dst);
+            if (dst.x + dst.w < 0 || dst.x > view_w || dst.y + dst.h < 0 || dst.y > view_h) continue;
+            render_snapshot_sprite(out, current_frame, &dst, SDL_FLIP_NONE);
         }
     }
-}
\ No newline at end of file
+}
+
+void projectile_pool_clear(ProjectilePool *pool, struct EnemyStore *enemies) {
+    pool->count = 0;
+    // Every slot of the block: a type that failed to load has no capacity left but keeps its range
+    if (enemies && enemies->projectiles_live) memset(enemies->projectiles_live, 0, (size_t)enemies->capacity);
+}
+
+void projectile_pool_cleanup(ProjectilePool *pool) {
+    if (!pool->arena_owned) mem_free(pool->x);
+    memset(pool, 0, sizeof(*pool));
+}
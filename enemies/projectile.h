@@ -2,21 +2,61 @@
 #define PROJECTILE_H
 
 #include <SDL.h>
+#include <stdbool.h>
 #include "../player/player.h"
 #include "../entity/spriteFramesArray.h"
 
+#define PROJECTILE_POOL_CAPACITY 512 // live projectiles per level
+#define PROJECTILE_MAX_KINDS 8
+
+// Who a projectile can hit
+#define PROJECTILE_TEAM_ENEMY  0 // hits the player
+#define PROJECTILE_TEAM_PLAYER 1 // hits enemies
+
+struct Arena;
+struct Map;
+struct EnemyStore;
+struct RenderSnapshot;
+
+// Sprite and size shared by every projectile of one kind
+typedef struct {
+    const SpriteFrameArray *sprite; // owned by whoever registered it (e.g. the enemy type)
+    int w, h;
+} ProjectileKind;
+
+/*
+ * Level-wide projectile pool in struct-of-arrays layout.
+ * Live projectiles are packed in [0, count); expiring one moves the last
+ * into its slot, so update and render never walk dead entries.
+ */
 typedef struct {
-    SDL_Rect rect;
-    float x, y; // exact position as floats for smooth movement
-    float vel_x, vel_y;
-    int damage;
-    bool active;
-    SpriteFrameArray sprite;
-    int current_frame;
-} Projectile;
-
-// projectile.h Korrektur
-void projectiles_update(Projectile projectiles[], Player *player);
-void projectiles_render(SDL_Renderer *renderer, Projectile projectiles[], int camera_x, int camera_y);
-
-#endif
\ No newline at end of file
+    int count;
+    int capacity;
+
+    float *x, *y;         // top-left, exact position as floats for smooth movement
+    float *vel_x, *vel_y;
+    int *damage;
+    Sint16 *owner;        // enemy store index of the shooter, -1 = none
+    Uint8 *kind;
+    Uint8 *team;
+
+    ProjectileKind kinds[PROJECTILE_MAX_KINDS];
+    int kind_count;
+
+    int world_w, world_h; // projectiles leaving the map expire
+    size_t block_size;    // all arrays, starting at x
+    bool arena_owned;
+} ProjectilePool;
+
+bool projectile_pool_init(ProjectilePool *pool, int capacity, int world_w, int world_h, struct Arena *arena);
+// Returns the kind id for spawning, or -1 when the table is full
+int projectile_pool_add_kind(ProjectilePool *pool, const SpriteFrameArray *sprite, int w, int h);
+bool projectile_spawn(ProjectilePool *pool, int kind, int team, int owner, float x, float y, float vel_x, float vel_y, int damage);
+// Moves every projectile, expires them on Collision shapes, map bounds and hits
+void projectiles_update(ProjectilePool *pool, Player *player, struct EnemyStore *enemies, struct Map *map, Uint32 now);
+// One pass per kind so consecutive copies share a texture
+void projectiles_render(struct RenderSnapshot *out, const ProjectilePool *pool, int camera_x, int camera_y, int view_w, int view_h, Uint32 now);
+void projectile_pool_clear(ProjectilePool *pool, struct EnemyStore *enemies);
+void projectile_pool_cleanup(ProjectilePool *pool);
+
+#endif
@@ -1,79 +1,61 @@
 // ranged.c
 #include "ranged.h"
+#include <math.h>
 
-bool ranged_check_player_in_range(RangedEnemy *enemy, Player *player) {
-    float dx = player->entity.rect.x - enemy->base.entity.rect.x;
+bool ranged_check_player_in_range(const SDL_Rect *enemy_rect, Player *player) {
+    float dx = player->entity.rect.x - enemy_rect->x;
     return fabs(dx) <= RANGED_ATTACK_RANGE;
 }
 
-void enemy_handle_ranged_attack(RangedEnemy *enemy, Player *player) {
-    Entity *e = &enemy->base.entity;
-    uint32_t now = SDL_GetTicks();
-
+static void enemy_handle_ranged_attack(EnemyStore *store, int i, const EnemyTypeInfo *type, Player *player,
+                                       ProjectilePool *pool, Uint32 now) {
     // animation still running?
-    bool is_animating = (now < enemy->base.attack_timer_end);
+    bool is_animating = (now < store->attack_timer_end[i]);
 
-    if (!is_animating && now < enemy->shoot_cooldown_end) return;
+    if (!is_animating && now < store->shoot_cooldown_end[i]) return;
 
     // start animation if not already running
     if (!is_animating) {
-        int anim_duration = e->attack.count * ENEMY_ANIMATION_SPEED;
-        enemy->base.attack_timer_end = now + anim_duration;
-        e->current_attack_frame = 0;
-        enemy->has_fired = false; // reset fire flag for new animation cycle
+        Uint32 anim_duration = type->attack.count * FRAME_TICKS(ENEMY_ANIMATION_SPEED);
+        store->attack_timer_end[i] = now + anim_duration;
+        store->frame_attack[i] = 0;
+        store->flags[i] &= (Uint8)~ENEMY_FLAG_HAS_FIRED; // reset fire flag for new animation cycle
         return; 
     }
 
     // projectil launch timing
-    int trigger_frame = e->attack.count - 4;
+    int trigger_frame = type->attack.count - 4;
     if (trigger_frame < 0) trigger_frame = 0;
 
-    if (!enemy->has_fired && e->current_attack_frame >= trigger_frame) {
-        for (int i = 0; i < MAX_PROJECTILES; i++) {
-            if (!enemy->projectiles[i].active) {
-                Projectile *p = &enemy->projectiles[i];
-                p->active = true;
-                
-                float spawn_x = e->rect.x + (e->rect.w / 2.0f);
-                float spawn_y = e->rect.y + (e->rect.h / 2.0f);
+    if (!(store->flags[i] & ENEMY_FLAG_HAS_FIRED) && store->frame_attack[i] >= trigger_frame
+        && store->projectiles_live[i] < MAX_PROJECTILES) {
+        const SDL_Rect *r = &store->rect[i];
+
+        float spawn_x = r->x + (r->w / 2.0f);
+        float spawn_y = r->y + (r->h / 2.0f);
 
-                float player_center_x = player->entity.rect.x + (player->entity.rect.w / 2.0f);
-                float direction = (player_center_x > spawn_x) ? 1.0f : -1.0f;
+        float player_center_x = player->entity.rect.x + (player->entity.rect.w / 2.0f);
+        float direction = (player_center_x > spawn_x) ? 1.0f : -1.0f;
 
-                float launch_offset = 40.0f; 
-                p->x = spawn_x + (launch_offset * direction);
-                p->y = spawn_y - 10.0f;
-                
-                p->rect.x = (int)p->x;
-                p->rect.y = (int)p->y;
-                p->vel_x = enemy->proj_vel_x * direction; 
-                p->vel_y = enemy->proj_vel_y; // 0 for straight, negative for upward arc
-                p->damage = enemy->proj_damage;
+        float launch_offset = 40.0f; 
+        // proj_vel_y: 0 for straight, negative for upward arc
+        if (projectile_spawn(pool, store->projectile_kind[store->type[i]], PROJECTILE_TEAM_ENEMY, i,
+                             spawn_x + (launch_offset * direction), spawn_y - 10.0f,
+                             type->proj_vel_x * direction, type->proj_vel_y, type->proj_damage)) {
+            store->projectiles_live[i]++;
 
-                // Flag for only firing once per animation
-                enemy->has_fired = true; 
+            // Flag for only firing once per animation
+            store->flags[i] |= ENEMY_FLAG_HAS_FIRED;
 
-                // cooldown for next shot starts when we fire, not at the start of the animation
-                enemy->shoot_cooldown_end = now + enemy->cooldown_ms;
-                break;
-            }
+            // cooldown for next shot starts when we fire, not at the start of the animation
+            store->shoot_cooldown_end[i] = now + FRAME_TICKS(type->cooldown_ms);
         }
     }
 }
 
-void projectile_sprite_cleanup(RangedEnemy *enemy) {
-    if (!enemy) return;
-    if (enemy->projectiles[0].sprite.frames != NULL) {
-        for (int i = 0; i < enemy->projectiles[0].sprite.count; i++) {
-            if (enemy->projectiles[0].sprite.frames[i]) {
-                SDL_DestroyTexture(enemy->projectiles[0].sprite.frames[i]);
-            }
-        }
-        free(enemy->projectiles[0].sprite.frames);
-        for (int i = 0; i < MAX_PROJECTILES; i++) {
-            enemy->projectiles[i].sprite.frames = NULL;
-            enemy->projectiles[i].sprite.count = 0;
-            enemy->projectiles[i].active = false;
-        }
+void ranged_enemy_attack(EnemyStore *store, int i, const EnemyTypeInfo *type, Player *player, ProjectilePool *pool, Uint32 now) {
+    // Range is horizontal only, walls are taken care of by the cached line of sight
+    if ((store->flags[i] & ENEMY_FLAG_SEES_PLAYER) && ranged_check_player_in_range(&store->rect[i], player)) {
+        enemy_handle_ranged_attack(store, i, type, player, pool, now);
     }
-}
\ No newline at end of file
+}
@@ -7,22 +7,9 @@
 #define RANGED_DETECTION_RANGE 250 // doesnt really matter much
 // doesn't walk towards player, just stands still and shoots when player is in range
 #define RANGED_ATTACK_RANGE 200
-#define MAX_PROJECTILES 2 // amount of projectiles a ranged enemy can have active at once
 
-typedef struct {
-    Enemy base;
-    Projectile projectiles[MAX_PROJECTILES];
-    int shoot_cooldown_end; // flag for timing next shot after animation
-    float proj_vel_x;
-    float proj_vel_y;
-    int proj_damage;
-    int cooldown_ms; // time between shots in milliseconds
-    bool has_fired; // for timing projectile spawn to animation frame
-
-} RangedEnemy;
-
-bool ranged_check_player_in_range(RangedEnemy *enemy, Player *player);
-void enemy_handle_ranged_attack(RangedEnemy *enemy, Player *player);
-void projectile_sprite_cleanup(RangedEnemy *enemy);
+bool ranged_check_player_in_range(const SDL_Rect *enemy_rect, Player *player);
+// Candidate i comes from the grid query around the player
+void ranged_enemy_attack(EnemyStore *store, int i, const EnemyTypeInfo *type, Player *player, ProjectilePool *pool, Uint32 now);
 
 #endif
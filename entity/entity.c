@@ -1,12 +1,16 @@
 #include "entity.h"
 #include "../map/map.h"
+#include "../memory/arena.h"
+#include "../render/renderSnapshot.h"
+#include "../clock/frameClock.h"
+#include "../texture/textureResidency.h"
+#include "../assets/assetPack.h"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
-#include <unistd.h>
 
 extern int map_get_floor_height(struct Map *map, int x, int y);
 extern int map_is_solid(struct Map *map, int x, int y);
@@ -17,27 +21,53 @@ extern void debug_log(const char *format, ...);
 // Frames (Unchanged)
 // ------------------------
 bool entity_frame_exists(const char *filepathname) {
-    return access(filepathname, F_OK) != -1;
+    // Looked up in the pack's table of contents, frames are counted without touching the filesystem
+    return asset_exists(filepathname);
+}
+
+static SDL_Texture **entity_alloc_frames(struct Arena *arena, int count) {
+    size_t bytes = sizeof(SDL_Texture*) * count;
+    return arena ? arena_alloc(arena, MEM_TAG_SPRITES, bytes) : mem_alloc(MEM_TAG_SPRITES, bytes);
 }
 
 int entity_load_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path) {
+    return entity_load_frames_arena(renderer, out, base_path, NULL);
+}
+
+int entity_load_frames_arena(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path, struct Arena *arena) {
     char path[256];
+    int available = 0;
     int count = 0;
 
     out->frames = NULL;
     out->count  = 0;
     out->sprite_w = 0;
     out->sprite_h = 0;
+    out->arena_owned = arena != NULL;
+    out->clip = NULL;
 
     debug_log("FRAME_LOAD: Suche Frames in %s", base_path);
 
+    // Count first so the array is allocated once instead of grown per frame
     for (int i = 1;; i++) {
         snprintf(path, sizeof(path), "%s%d.png", base_path, i);
-        if (!entity_frame_exists(path)) {
-            if (i == 1) debug_log("FRAME_WARN: Erste Datei nicht gefunden: %s", path);
-            break;
-        }
+        if (!entity_frame_exists(path)) break;
+        available++;
+    }
+    if (available == 0) {
+        debug_log("FRAME_WARN: Erste Datei nicht gefunden: %s1.png", base_path);
+        return 0;
+    }
 
+    out->frames = entity_alloc_frames(arena, available);
+    if (!out->frames) {
+        debug_log("FRAME_CRITICAL: Out of Memory fuer %d Frames", available);
+        mem_track_report("Out of Memory");
+        return 0;
+    }
+
+    for (int i = 1; i <= available; i++) {
+        snprintf(path, sizeof(path), "%s%d.png", base_path, i);
         SDL_Texture *tex = load_texture(renderer, path);
         if (!tex) {
             debug_log("FRAME_ERROR: Fehler beim Laden von %s", path);
@@ -45,14 +75,6 @@ int entity_load_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char
         }
 
         if (count == 0) SDL_QueryTexture(tex, NULL, NULL, &out->sprite_w, &out->sprite_h);
-        
-        SDL_Texture **tmp = realloc(out->frames, sizeof(SDL_Texture*) * (count + 1));
-        if (!tmp) { 
-            debug_log("FRAME_CRITICAL: Out of Memory bei Frame %d", i);
-            SDL_DestroyTexture(tex); 
-            break; 
-        }
-        out->frames = tmp;
         out->frames[count++] = tex;
     }
     
@@ -63,26 +85,66 @@ int entity_load_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char
 }
 
 int entity_load_frame(SDL_Renderer *renderer, SpriteFrameArray *out, const char *filepathname) {
+    return entity_load_frame_arena(renderer, out, filepathname, NULL);
+}
+
+int entity_load_frame_arena(SDL_Renderer *renderer, SpriteFrameArray *out, const char *filepathname, struct Arena *arena) {
     debug_log("FRAME_SINGLE: Lade Einzelbild %s", filepathname);
     SDL_Texture *tex = load_texture(renderer, filepathname);
     if (!tex) {
         debug_log("FRAME_ERROR: Konnte %s nicht laden", filepathname);
         return 0;
     }
-    out->frames = malloc(sizeof(SDL_Texture*));
+    out->frames = entity_alloc_frames(arena, 1);
     if (!out->frames) { 
-        SDL_DestroyTexture(tex); 
+        mem_track_texture_destroy(tex);
         return 0; 
     }
     out->frames[0] = tex;
     out->count = 1;
+    out->arena_owned = arena != NULL;
+    out->clip = NULL;
     SDL_QueryTexture(tex, NULL, NULL, &out->sprite_w, &out->sprite_h);
     return 1;
 }
 
+int entity_register_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path) {
+    char path[256];
+    int available = 0;
+    int w = 0, h = 0;
+
+    for (int i = 1;; i++) {
+        snprintf(path, sizeof(path), "%s%d.png", base_path, i);
+        if (!entity_frame_exists(path)) break;
+        available++;
+    }
+    snprintf(path, sizeof(path), "%s1.png", base_path);
+    // Without a readable header the size is unknown, so the clip is loaded right away
+    if (available == 0 || !texture_png_size(path, &w, &h) ||
+        !texture_clip_register(out, base_path, false, available, w, h)) {
+        return entity_load_frames(renderer, out, base_path);
+    }
+    debug_log("FRAME_LAZY: %d Frames registriert fuer %s (Groesse: %dx%d)", available, base_path, w, h);
+    return available;
+}
+
+int entity_register_frame(SDL_Renderer *renderer, SpriteFrameArray *out, const char *filepathname) {
+    int w = 0, h = 0;
+    if (!texture_png_size(filepathname, &w, &h) || !texture_clip_register(out, filepathname, true, 1, w, h)) {
+        return entity_load_frame(renderer, out, filepathname);
+    }
+    debug_log("FRAME_LAZY: Einzelbild registriert %s (Groesse: %dx%d)", filepathname, w, h);
+    return 1;
+}
+
 void entity_free_frames(SpriteFrameArray *a){
-    for(int i=0;i<a->count;i++) SDL_DestroyTexture(a->frames[i]);
-    free(a->frames);
+    if (a->clip) {
+        texture_clip_release(a);
+        return;
+    }
+    for(int i=0;i<a->count;i++) mem_track_texture_destroy(a->frames[i]);
+    // Arena-owned arrays are released together with the level arena
+    if (!a->arena_owned) mem_free(a->frames);
     a->frames = NULL;
     a->count = 0;
 }
@@ -98,31 +160,31 @@ void entity_cleanup(Entity *e){
 }
 
 
-void entity_update_physics(Entity *e, Map *map, float gravity, float max_fall_speed) {
+void entity_move_and_collide(SDL_Rect *rect, float *vel_x, float *vel_y, int *on_ground, Map *map, float gravity, float max_fall_speed) {
     // ============================================================
     // 1. X-AXIS MOVEMENT
     // ============================================================
-    int original_x = e->rect.x;
-    int next_x = e->rect.x + (int)e->vel_x;
+    int original_x = rect->x;
+    int next_x = rect->x + (int)*vel_x;
 
     // We tentatively apply the move
-    e->rect.x = next_x;
+    rect->x = next_x;
 
     // Check HEAD collision (Ceiling / Low Overhangs)
     // If the head is inside a solid block, we stop immediately.
     // We check the leading edge + offset to avoid clipping.
-    int direction = (e->vel_x > 0) ? 1 : -1;
-    int lead_x = (direction > 0) ? e->rect.x + e->rect.w : e->rect.x;
+    int direction = (*vel_x > 0) ? 1 : -1;
+    int lead_x = (direction > 0) ? rect->x + rect->w : rect->x;
 
-    if (map_is_solid(map, lead_x, e->rect.y)) {
+    if (map_is_solid(map, lead_x, rect->y)) {
         // Head hit a wall -> Revert X
-        e->rect.x = original_x;
-        e->vel_x = 0;
+        rect->x = original_x;
+        *vel_x = 0;
     }
     else {
         // FEET / SLOPE COLLISION
-        int feet_y = e->rect.y + e->rect.h;
-        int center_x = e->rect.x + (e->rect.w / 2);
+        int feet_y = rect->y + rect->h;
+        int center_x = rect->x + (rect->w / 2);
 
         // Check floor height at the NEW center position
         int new_floor = map_get_floor_height(map, center_x, feet_y);
@@ -137,15 +199,15 @@ void entity_update_physics(Entity *e, Map *map, float gravity, float max_fall_sp
             // Any step higher than 24px is treated as a WALL.
             if (diff > 24) {
                 // Wall is too steep -> Revert X
-                e->rect.x = original_x;
-                e->vel_x = 0;
+                rect->x = original_x;
+                *vel_x = 0;
             }
                 // If it is a walkable slope (Up or Down within limit)
             else if (abs(diff) <= 24) {
                 // If we are on the ground (or close enough to snap), adjust Y
-                if (e->on_ground) {
-                    e->rect.y = new_floor - e->rect.h;
-                    e->vel_y = 0;
+                if (*on_ground) {
+                    rect->y = new_floor - rect->h;
+                    *vel_y = 0;
                 }
             }
             // If diff < -24 (Falling off a cliff), we do nothing here.
@@ -156,64 +218,67 @@ void entity_update_physics(Entity *e, Map *map, float gravity, float max_fall_sp
     // ============================================================
     // 2. Y-AXIS MOVEMENT
     // ============================================================
-    e->vel_y += gravity;
-    if(e->vel_y > max_fall_speed) e->vel_y = max_fall_speed;
+    *vel_y += gravity;
+    if(*vel_y > max_fall_speed) *vel_y = max_fall_speed;
 
-    if (e->vel_y < 0) {
+    if (*vel_y < 0) {
         // --- JUMPING ---
-        int next_y = e->rect.y + (int)e->vel_y;
+        int next_y = rect->y + (int)*vel_y;
 
         // Check Head corners
-        if (map_is_solid(map, e->rect.x, next_y) ||
-            map_is_solid(map, e->rect.x + e->rect.w, next_y)) {
-            e->vel_y = 0;
-            e->rect.y = ((e->rect.y / 16) + 1) * 16; // Snap down
+        if (map_is_solid(map, rect->x, next_y) ||
+            map_is_solid(map, rect->x + rect->w, next_y)) {
+            *vel_y = 0;
+            rect->y = ((rect->y / 16) + 1) * 16; // Snap down
         } else {
-            e->rect.y = next_y;
+            rect->y = next_y;
         }
-        e->on_ground = 0;
+        *on_ground = 0;
     }
     else {
         // --- FALLING / STICKY ---
 
         // Sticky Logic: Before moving down, check if we can stick to floor
-        int center_x = e->rect.x + e->rect.w/2;
-        int feet_y   = e->rect.y + e->rect.h;
+        int center_x = rect->x + rect->w/2;
+        int feet_y   = rect->y + rect->h;
         int current_floor = map_get_floor_height(map, center_x, feet_y);
         int snapped = 0;
 
         // If grounded and floor is close (<= 10px), stick to it
         // 10px handles steep descents (45 degrees) better than 6px
-        if (e->on_ground && current_floor != -1) {
+        if (*on_ground && current_floor != -1) {
             if (abs(current_floor - feet_y) <= 10) {
-                e->rect.y = current_floor - e->rect.h;
-                e->vel_y = 0;
+                rect->y = current_floor - rect->h;
+                *vel_y = 0;
                 snapped = 1;
             }
         }
 
         if (!snapped) {
-            e->rect.y += (int)e->vel_y;
+            rect->y += (int)*vel_y;
 
             // Landing Logic
-            int new_feet_y = e->rect.y + e->rect.h;
+            int new_feet_y = rect->y + rect->h;
             int final_floor = map_get_floor_height(map, center_x, new_feet_y);
 
             if (final_floor != -1 && new_feet_y >= final_floor - 2) {
-                e->rect.y = final_floor - e->rect.h;
-                e->vel_y = 0;
-                e->on_ground = 1;
+                rect->y = final_floor - rect->h;
+                *vel_y = 0;
+                *on_ground = 1;
             } else {
-                e->on_ground = 0;
+                *on_ground = 0;
             }
         }
     }
-    if (e->rect.y > 1000) { 
-        debug_log("PHYSICS_WARN: Entity bei Y=%d (aus der Map gefallen?)", e->rect.y);
+    if (rect->y > 1000) { 
+        debug_log("PHYSICS_WARN: Entity bei Y=%d (aus der Map gefallen?)", rect->y);
     }
 }
-void entity_update_animation(Entity *e, int is_moving, Uint32 speed) {
-    Uint32 now = SDL_GetTicks();
+
+void entity_update_physics(Entity *e, Map *map, float gravity, float max_fall_speed) {
+    entity_move_and_collide(&e->rect, &e->vel_x, &e->vel_y, &e->on_ground, map, gravity, max_fall_speed);
+}
+void entity_update_animation(Entity *e, int is_moving, Uint32 speed, Uint32 now) {
     if (now - e->last_time < speed) return;
     e->last_time = now;
 
@@ -233,13 +298,12 @@ void entity_update_animation(Entity *e, int is_moving, Uint32 speed) {
     }
 }
 
-void entity_render(SDL_Renderer *renderer, Entity *e, SDL_Texture *current_texture, int camera_x, int camera_y) {
+void entity_render(RenderSnapshot *out, Entity *e, SDL_Texture *current_texture, int camera_x, int camera_y) {
     if (!current_texture) {
         // Das ist vermutlich der Grund für den unsichtbaren ShurikenDude!
-        static Uint32 last_render_err = 0;
-        if (SDL_GetTicks() - last_render_err > 5000) {
+        static int render_err_calls = 0;
+        if (render_err_calls++ % 300 == 0) {
             debug_log("RENDER_ERROR: current_texture ist NULL für Entity!");
-            last_render_err = SDL_GetTicks();
         }
         return;
     }
@@ -248,15 +312,24 @@ void entity_render(SDL_Renderer *renderer, Entity *e, SDL_Texture *current_textu
             e->rect.y - e->offset_y - camera_y,
             e->sprite_w, e->sprite_h
     };
-    SDL_RenderCopyEx(renderer, current_texture, NULL, &render_rect, 0.0, NULL, e->flip_direction);
+    render_snapshot_sprite(out, current_texture, &render_rect, e->flip_direction);
+}
+
+RenderItem *entity_draw_sprite(RenderSnapshot *out, const SpriteFrameArray *frames, int frame, const SDL_Rect *hitbox, int offset_x, int offset_y,
+                               int sprite_w, int sprite_h, SDL_RendererFlip flip, int camera_x, int camera_y) {
+    SDL_Rect render_rect = {
+            hitbox->x - offset_x - camera_x,
+            hitbox->y - offset_y - camera_y,
+            sprite_w, sprite_h
+    };
+    return render_snapshot_frame(out, frames, frame, &render_rect, flip);
 }
 
-void entity_update_death(Entity *e) {
+void entity_update_death(Entity *e, Uint32 now) {
     Mix_HaltChannel(e->grunt_sfx_channel);
     e->grunt_sfx_channel = -1;
     if (e->death.count == 0) { e->is_dead = 1; return; }
-    Uint32 now = SDL_GetTicks();
-    if (now - e->death_last_time < 100) return;
+    if (now - e->death_last_time < FRAME_TICKS(100)) return;
     e->death_last_time = now;
     e->current_death_frame++;
     if (e->alpha > 10) e->alpha -= 10; else e->alpha = 0;
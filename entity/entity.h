@@ -5,6 +5,9 @@
 #include "spriteFramesArray.h"
 #include "../bgm/bgmHandler.h"
 
+struct RenderSnapshot;
+struct RenderItem;
+
 typedef struct {
     SDL_Rect rect;
     float vel_x, vel_y;
@@ -46,15 +49,29 @@ typedef struct {
 } Entity;
 
 struct Map;
+struct Arena;
 
 bool entity_frame_exists(const char *filepathname);
 int entity_load_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path);
 int entity_load_frame(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path);
+// Same as above, but the frame array comes from a level arena (NULL = malloc)
+int entity_load_frames_arena(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path, struct Arena *arena);
+int entity_load_frame_arena(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path, struct Arena *arena);
+// Lazy variants: count and size now, textures on first draw (texture/textureResidency.h).
+// Fall back to loading right away when the clip cannot be registered
+int entity_register_frames(SDL_Renderer *renderer, SpriteFrameArray *out, const char *base_path);
+int entity_register_frame(SDL_Renderer *renderer, SpriteFrameArray *out, const char *filepathname);
 void entity_free_frames(SpriteFrameArray *a);
 void entity_cleanup(Entity *e);
 void entity_update_physics(Entity *e, struct Map *map, float gravity, float max_fall_speed);
-void entity_update_animation(Entity *e, int is_moving, Uint32 animation_speed);
-void entity_render(SDL_Renderer *renderer, Entity *e, SDL_Texture *current_texture, int camera_x, int camera_y);
-void entity_update_death(Entity *e);
+// Same collision response on loose fields, used by the struct-of-arrays enemy store
+void entity_move_and_collide(SDL_Rect *rect, float *vel_x, float *vel_y, int *on_ground, struct Map *map, float gravity, float max_fall_speed);
+// animation_speed in ticks, now is the FrameClock tick
+void entity_update_animation(Entity *e, int is_moving, Uint32 animation_speed, Uint32 now);
+// Both record into the frame's render snapshot, the draw call itself happens in render_snapshot_submit
+void entity_render(struct RenderSnapshot *out, Entity *e, SDL_Texture *current_texture, int camera_x, int camera_y);
+struct RenderItem *entity_draw_sprite(struct RenderSnapshot *out, const SpriteFrameArray *frames, int frame, const SDL_Rect *hitbox, int offset_x, int offset_y,
+                                      int sprite_w, int sprite_h, SDL_RendererFlip flip, int camera_x, int camera_y);
+void entity_update_death(Entity *e, Uint32 now);
 
 #endif
\ No newline at end of file
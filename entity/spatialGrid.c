@@ -0,0 +1,138 @@
+#include "spatialGrid.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../memory/arena.h"
+
+extern void debug_log(const char *format, ...);
+
+static int spatial_grid_clamp(int v, int max) {
+    if (v < 0) return 0;
+    if (v >= max) return max - 1;
+    return v;
+}
+
+static int spatial_grid_cell_for(const SpatialGrid *grid, const SDL_Rect *rect) {
+    int cx = spatial_grid_clamp((rect->x + rect->w / 2) / grid->cell_size, grid->cols);
+    int cy = spatial_grid_clamp((rect->y + rect->h / 2) / grid->cell_size, grid->rows);
+    return cy * grid->cols + cx;
+}
+
+bool spatial_grid_init(SpatialGrid *grid, int capacity, int world_w, int world_h, int cell_size, Arena *arena) {
+    memset(grid, 0, sizeof(*grid));
+    grid->cell_size = cell_size;
+    grid->cols = (world_w + cell_size - 1) / cell_size;
+    grid->rows = (world_h + cell_size - 1) / cell_size;
+    if (grid->cols < 1) grid->cols = 1;
+    if (grid->rows < 1) grid->rows = 1;
+    grid->capacity = capacity;
+
+    int cells = grid->cols * grid->rows;
+    size_t bytes = sizeof(int) * ((size_t)cells + 3 * (size_t)capacity);
+    int *block = arena ? arena_alloc(arena, MEM_TAG_ENEMIES, bytes) : mem_alloc(MEM_TAG_ENEMIES, bytes);
+    if (!block) {
+        debug_log("GRID_ERROR: Kein Speicher fuer %dx%d Zellen", grid->cols, grid->rows);
+        grid->capacity = 0;
+        return false;
+    }
+    grid->arena_owned = arena != NULL;
+    grid->block_size = bytes;
+
+    grid->cell_head = block;
+    grid->next = grid->cell_head + cells;
+    grid->prev = grid->next + capacity;
+    grid->cell_of = grid->prev + capacity;
+    memset(block, 0xFF, bytes); // every slot -1
+
+    debug_log("GRID: %dx%d Zellen a %dpx fuer %d Eintraege", grid->cols, grid->rows, cell_size, capacity);
+    return true;
+}
+
+static void spatial_grid_link(SpatialGrid *grid, int id, int cell) {
+    int head = grid->cell_head[cell];
+    grid->prev[id] = -1;
+    grid->next[id] = head;
+    if (head >= 0) grid->prev[head] = id;
+    grid->cell_head[cell] = id;
+    grid->cell_of[id] = cell;
+}
+
+static void spatial_grid_unlink(SpatialGrid *grid, int id) {
+    int cell = grid->cell_of[id];
+    int prev = grid->prev[id];
+    int next = grid->next[id];
+    if (prev >= 0) grid->next[prev] = next;
+    else grid->cell_head[cell] = next;
+    if (next >= 0) grid->prev[next] = prev;
+    grid->cell_of[id] = -1;
+}
+
+void spatial_grid_insert(SpatialGrid *grid, int id, const SDL_Rect *rect) {
+    if (id < 0 || id >= grid->capacity) return;
+    if (grid->cell_of[id] >= 0) spatial_grid_unlink(grid, id);
+    if (rect->w / 2 + 1 > grid->max_half_w) grid->max_half_w = rect->w / 2 + 1;
+    if (rect->h / 2 + 1 > grid->max_half_h) grid->max_half_h = rect->h / 2 + 1;
+    spatial_grid_link(grid, id, spatial_grid_cell_for(grid, rect));
+}
+
+void spatial_grid_remove(SpatialGrid *grid, int id) {
+    if (id < 0 || id >= grid->capacity || grid->cell_of[id] < 0) return;
+    spatial_grid_unlink(grid, id);
+}
+
+void spatial_grid_update(SpatialGrid *grid, int id, const SDL_Rect *rect) {
+    if (id < 0 || id >= grid->capacity || grid->cell_of[id] < 0) return;
+    int cell = spatial_grid_cell_for(grid, rect);
+    if (cell == grid->cell_of[id]) return;
+    spatial_grid_unlink(grid, id);
+    spatial_grid_link(grid, id, cell);
+}
+
+// Cell range that can hold items touching area
+static void spatial_grid_cells(const SpatialGrid *grid, const SDL_Rect *area, int *x0, int *y0, int *x1, int *y1) {
+    // An item can reach up to its half-extent out of the cell holding its center
+    *x0 = spatial_grid_clamp((area->x - grid->max_half_w) / grid->cell_size, grid->cols);
+    *y0 = spatial_grid_clamp((area->y - grid->max_half_h) / grid->cell_size, grid->rows);
+    *x1 = spatial_grid_clamp((area->x + area->w + grid->max_half_w) / grid->cell_size, grid->cols);
+    *y1 = spatial_grid_clamp((area->y + area->h + grid->max_half_h) / grid->cell_size, grid->rows);
+}
+
+int spatial_grid_query(const SpatialGrid *grid, const SDL_Rect *area, int *out, int max_out) {
+    if (!grid->cell_head) return 0;
+
+    int x0, y0, x1, y1;
+    spatial_grid_cells(grid, area, &x0, &y0, &x1, &y1);
+
+    int found = 0;
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int id = grid->cell_head[cy * grid->cols + cx]; id >= 0; id = grid->next[id]) {
+                if (found == max_out) {
+                    debug_log("GRID_WARN: Abfrage nach %d Eintraegen abgeschnitten", max_out);
+                    return found;
+                }
+                out[found++] = id;
+            }
+        }
+    }
+    return found;
+}
+
+void spatial_grid_visit(const SpatialGrid *grid, const SDL_Rect *area, SpatialGridVisitor visit, void *ctx) {
+    if (!grid->cell_head) return;
+
+    int x0, y0, x1, y1;
+    spatial_grid_cells(grid, area, &x0, &y0, &x1, &y1);
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int id = grid->cell_head[cy * grid->cols + cx]; id >= 0; id = grid->next[id]) {
+                if (!visit(ctx, id)) return;
+            }
+        }
+    }
+}
+
+void spatial_grid_cleanup(SpatialGrid *grid) {
+    if (!grid->arena_owned) mem_free(grid->cell_head);
+    memset(grid, 0, sizeof(*grid));
+}
@@ -0,0 +1,45 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+#define SPATIAL_GRID_CELL 64     // px, about two enemy widths
+
+struct Arena;
+
+/*
+ * Uniform broadphase grid over the level. Items are ids (e.g. enemy store
+ * indices) filed by the center of their rect in intrusive per-cell lists.
+ * spatial_grid_update() only relinks when an item crosses a cell border,
+ * so a moving item costs O(1). Queries widen the area by the largest
+ * inserted half-extent and return candidates; callers do the exact test.
+ * spatial_grid_visit() has no result limit, spatial_grid_query() fills a
+ * caller buffer and is meant for buffers sized to the capacity.
+ */
+typedef struct SpatialGrid {
+    int cell_size;
+    int cols, rows;
+    int capacity;
+    int max_half_w, max_half_h;
+    int *cell_head;   // first id per cell, -1 = empty
+    int *next;
+    int *prev;
+    int *cell_of;     // -1 = not in the grid
+    size_t block_size; // all four arrays, starting at cell_head
+    bool arena_owned;
+} SpatialGrid;
+
+bool spatial_grid_init(SpatialGrid *grid, int capacity, int world_w, int world_h, int cell_size, struct Arena *arena);
+void spatial_grid_insert(SpatialGrid *grid, int id, const SDL_Rect *rect);
+void spatial_grid_remove(SpatialGrid *grid, int id);
+void spatial_grid_update(SpatialGrid *grid, int id, const SDL_Rect *rect);
+// Writes up to max_out ids whose cells touch area, returns how many; a full buffer is logged
+int spatial_grid_query(const SpatialGrid *grid, const SDL_Rect *area, int *out, int max_out);
+// Calls visit for every id whose cell touches area until it returns false; visit must not
+// insert, remove or move items
+typedef bool (*SpatialGridVisitor)(void *ctx, int id);
+void spatial_grid_visit(const SpatialGrid *grid, const SDL_Rect *area, SpatialGridVisitor visit, void *ctx);
+void spatial_grid_cleanup(SpatialGrid *grid);
+
+#endif
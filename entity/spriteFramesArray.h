@@ -3,11 +3,15 @@
 #define SPRITEFRAMESARRAY_H
 #include <SDL.h>
 
+struct TextureClip;
+
 typedef struct {
     SDL_Texture **frames;  // dynamisches Array
     int count;             // wie viele Frames existieren
     int sprite_w;         // Breite eines Frames
     int sprite_h;         // Höhe eines Frames
+    int arena_owned;      // frames-Array gehoert der Level-Arena, kein free()
+    struct TextureClip *clip; // lazy geladen (texture/textureResidency.h), frames[i] NULL solange nicht resident
 } SpriteFrameArray;
 
 #endif // SPRITEFRAMESARRAY_H
\ No newline at end of file
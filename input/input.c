@@ -0,0 +1,54 @@
+#include "input.h"
+
+void input_init(void) {
+    // 0 = sample at vblank; the sampling cycle only matters for reads, peeks never wait
+    sceCtrlSetSamplingCycle(0);
+    sceCtrlSetSamplingMode(PSP_CTRL_MODE_ANALOG);
+}
+
+// Stick position 0..255 to -1..1 without the dead zone
+static float input_axis(unsigned char raw) {
+    float v = (raw - 128) / 127.0f;
+    if (v > 1.0f) v = 1.0f;
+    if (v < -1.0f) v = -1.0f;
+    if (v > -INPUT_ANALOG_DEADZONE && v < INPUT_ANALOG_DEADZONE) return 0.0f;
+    return v;
+}
+
+void input_sample(InputState *in, Uint32 tick) {
+    SceCtrlData pad;
+    // Peek returns the newest sample right away, Read would block until the next one
+    sceCtrlPeekBufferPositive(&pad, 1);
+
+    in->analog_x = input_axis(pad.Lx);
+    in->analog_y = input_axis(pad.Ly);
+
+    Uint32 held = pad.Buttons;
+    if (in->analog_x <= -INPUT_ANALOG_PRESS) held |= PSP_CTRL_LEFT;
+    if (in->analog_x >= INPUT_ANALOG_PRESS) held |= PSP_CTRL_RIGHT;
+    if (in->analog_y <= -INPUT_ANALOG_PRESS) held |= PSP_CTRL_UP;
+    if (in->analog_y >= INPUT_ANALOG_PRESS) held |= PSP_CTRL_DOWN;
+
+    in->pressed = held & ~in->held;
+    in->released = in->held & ~held;
+    in->held = held;
+    in->tick = tick;
+    in->sampled_at = SDL_GetPerformanceCounter();
+
+    for (int bit = 0; bit < 32; bit++) {
+        if (in->pressed & (1u << bit)) in->press_tick[bit] = tick;
+    }
+    in->buffered |= in->pressed;
+}
+
+bool input_buffered(const InputState *in, Uint32 button, Uint32 window) {
+    for (int bit = 0; bit < 32; bit++) {
+        Uint32 mask = 1u << bit;
+        if ((button & mask) && (in->buffered & mask) && in->tick - in->press_tick[bit] < window) return true;
+    }
+    return false;
+}
+
+void input_consume(InputState *in, Uint32 button) {
+    in->buffered &= ~button;
+}
@@ -0,0 +1,47 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include <pspctrl.h>
+
+// Analog stick: dead zone around the centre, and how far counts as a d-pad press
+#define INPUT_ANALOG_DEADZONE 0.25f
+#define INPUT_ANALOG_PRESS 0.5f
+
+/*
+ * Controller state of one tick. input_sample peeks at the latest pad state
+ * without waiting for the next vblank sample, once per tick on the main
+ * thread before the update starts; the update only reads it (and consumes
+ * buffered presses), so both never touch it at the same time.
+ *
+ * Buttons are PSP_CTRL_* masks; the analog stick counts as the d-pad once it
+ * is pushed past INPUT_ANALOG_PRESS.
+ */
+typedef struct InputState {
+    Uint32 held;
+    Uint32 pressed;          // down this tick, up the last
+    Uint32 released;
+    float analog_x, analog_y; // -1..1, 0 inside the dead zone
+    Uint32 tick;             // FrameClock tick of the sample
+    Uint64 sampled_at;       // performance counter, for latency measurements
+
+    // Press buffer: presses stay available for a window until consumed
+    Uint32 buffered;
+    Uint32 press_tick[32];   // by bit index
+} InputState;
+
+// Analog sampling mode and the fastest sampling cycle
+void input_init(void);
+// Non-blocking read of the pad, edges against the previous sample
+void input_sample(InputState *in, Uint32 tick);
+
+static inline bool input_held(const InputState *in, Uint32 button) { return (in->held & button) != 0; }
+static inline bool input_pressed(const InputState *in, Uint32 button) { return (in->pressed & button) != 0; }
+static inline bool input_released(const InputState *in, Uint32 button) { return (in->released & button) != 0; }
+
+// Pressed during the last window ticks and not consumed yet (jump buffering)
+bool input_buffered(const InputState *in, Uint32 button, Uint32 window);
+void input_consume(InputState *in, Uint32 button);
+
+#endif
@@ -4,18 +4,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "../entity/entity.h"
-#include <unistd.h>
+#include "../ui/ui.h"
+#include "../render/renderSnapshot.h"
 
 extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
 extern void debug_log(const char *format, ...);
 
 
-// Prüft, ob Datei existiert
-static bool chest_frame_exists(const char *path) {
-    return access(path, F_OK) != -1;
-}
-
-Chest chest_init(SDL_Renderer *renderer, const char *base_path, int x, int y, Item loot) {
+Chest chest_init(SDL_Renderer *renderer, const char *base_path, int x, int y, Item loot, struct Arena *arena) {
     Chest chest = {0};
     chest.rect.x = x;
     chest.rect.y = y;
@@ -23,41 +19,25 @@ Chest chest_init(SDL_Renderer *renderer, const char *base_path, int x, int y, It
     chest.opening = false;
     chest.current_frame = 0;
     chest.last_frame_time = 0;
-    chest.frame_delay = 150; // 300 ms pro Frame
-
-    // Dynamisch Frames zählen
-    int count = 0;
-    char path[256];
-    while (1) {
-        snprintf(path, sizeof(path), "%s%d.png", base_path, count + 1);
-        if (!chest_frame_exists(path)) break;
-        count++;
+    chest.frame_delay = FRAME_TICKS(150); // 150 ms pro Frame
+
+    // Frames liegen in der Level-Arena, das Array wird einmal passend reserviert
+    if (entity_load_frames_arena(renderer, &chest.frames, base_path, arena) > 0) {
+        chest.rect.w = chest.frames.sprite_w;
+        chest.rect.h = chest.frames.sprite_h;
+    } else {
+        debug_log("Chest frame load failed: %s", base_path);
     }
 
-    chest.frames.count = count;
-    chest.frames.frames = malloc(sizeof(SDL_Texture*) * count);
-
-    for (int i = 0; i < count; i++) {
-        snprintf(path, sizeof(path), "%s%d.png", base_path, i + 1);
-        chest.frames.frames[i] = load_texture(renderer, path);
-        if (!chest.frames.frames[i]) {
-            debug_log("Chest frame load failed: %s", path);
-        }
-    }
-
-    if (chest.frames.frames[0]) SDL_QueryTexture(chest.frames.frames[0], NULL, NULL, &chest.rect.w, &chest.rect.h);
-
     chest.loot = item_init(renderer, loot, x, y);
 
     return chest;
 }
 
-void chest_update(Chest *chest) {
+void chest_update(Chest *chest, Uint32 now) {
     if (!chest || chest->collected) return;
     if (!chest->opening) return;
 
-    Uint32 now = SDL_GetTicks();
-
     if (now - chest->last_frame_time >= chest->frame_delay) {
         chest->last_frame_time = now;   
         chest->current_frame++;          
@@ -69,11 +49,11 @@ void chest_update(Chest *chest) {
     }
 }
 
-void chest_render(SDL_Renderer *renderer, Chest *chest, int camera_x, int camera_y) {
-    if (!chest || chest->collected) return;
+void chest_render(RenderSnapshot *out, const Chest *chest, int camera_x, int camera_y) {
+    if (!chest || chest->collected || chest->frames.count == 0) return;
     SDL_Texture *tex = chest->frames.frames[chest->current_frame];
     SDL_Rect dst = {chest->rect.x - camera_x, chest->rect.y - camera_y, chest->rect.w * 1.5, chest->rect.h * 1.5};
-    SDL_RenderCopy(renderer, tex, NULL, &dst);
+    render_snapshot_sprite(out, tex, &dst, SDL_FLIP_NONE);
 }
 
 bool chest_check_collision(Chest *chest, SDL_Rect player_rect) {
@@ -83,12 +63,7 @@ bool chest_check_collision(Chest *chest, SDL_Rect player_rect) {
 
 void chest_cleanup(Chest *chest) {
     if (!chest) return;
-    for (int i = 0; i < chest->frames.count; i++) {
-        SDL_DestroyTexture(chest->frames.frames[i]);
-    }
-    free(chest->frames.frames);
-    chest->frames.frames = NULL;
-    chest->frames.count = 0;
+    entity_free_frames(&chest->frames);
 }
 
 void add_loot_to_player(Chest *chest, Player *player) {
@@ -98,6 +73,7 @@ void add_loot_to_player(Chest *chest, Player *player) {
     for (int i = 0; i < player->inventory_count; i++) {
         if (player->inventory[i].type == chest->loot.type) {
             player->inventory[i].amount += chest->loot.amount;
+            ui_mark_hud_dirty();
             printf("Item gestapelt! Anzahl: %d\n", player->inventory[i].amount);
             return;
         }
@@ -109,5 +85,6 @@ void add_loot_to_player(Chest *chest, Player *player) {
         player->inventory[player->inventory_count].amount = chest->loot.amount;
         player->inventory_count++;
         chest->collected = true;
+        ui_mark_hud_dirty();
     }
 }
\ No newline at end of file
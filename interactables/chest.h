@@ -11,17 +11,20 @@ typedef struct {
     SDL_Rect rect;
     bool collected;           // Bereits eingesammelt
     bool opening;             // Animation läuft
-    Uint32 last_frame_time;   // Timer für Animation
+    Uint32 last_frame_time;   // Timer für Animation (FrameClock tick)
     int current_frame;        // Aktuelles Animationsframe
-    int frame_delay;          // Zeit pro Frame in ms
+    Uint32 frame_delay;       // Zeit pro Frame in ticks
     SpriteFrameArray frames;    // Öffnungsanimation
     Item loot;                 // Beute im Inneren
 } Chest;
 
-Chest chest_init(SDL_Renderer *renderer, const char *base_path, int x, int y, Item loot);
-void chest_update(Chest *chest);
-void chest_render(SDL_Renderer *renderer, Chest *chest, int camera_x, int camera_y);
+struct Arena;
+struct RenderSnapshot;
+
+Chest chest_init(SDL_Renderer *renderer, const char *base_path, int x, int y, Item loot, struct Arena *arena);
+void chest_update(Chest *chest, Uint32 now);
+void chest_render(struct RenderSnapshot *out, const Chest *chest, int camera_x, int camera_y);
 bool chest_check_collision(Chest *chest, SDL_Rect player_rect);
-void chest_destroy(Chest *chest);
+void chest_cleanup(Chest *chest);
 void add_loot_to_player(Chest *chest, Player *player);
 #endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "item.h"
 #include <SDL2/SDL_image.h>
 #include "../player/player.h"
+#include "../ui/ui.h"
+#include "../memory/memTrack.h"
 
 
 #define HEALTH_POTION_PATH  "resources/sprites/items/item-114.png"
@@ -10,10 +12,22 @@
 
 extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
 
+// Chest loot and inventory stacks point at the same texture, so no Item owns it
+static SDL_Texture *g_item_textures[ITEM_TYPE_COUNT];
+
+SDL_Texture *item_texture(ItemType type) {
+    if (type < 0 || type >= ITEM_TYPE_COUNT) return NULL;
+    return g_item_textures[type];
+}
+
 Item item_init(SDL_Renderer *renderer, Item item, int x, int y) {
     const char* path = (item.type == HEALTH_POTION) ? HEALTH_POTION_PATH : MANA_POTION_PATH;
     
-    item.texture = load_texture(renderer, path);
+    item.texture = item_texture(item.type);
+    if (!item.texture && item.type >= 0 && item.type < ITEM_TYPE_COUNT) {
+        item.texture = load_texture(renderer, path);
+        g_item_textures[item.type] = item.texture;
+    }
     
     if (item.texture) {
         SDL_QueryTexture(item.texture, NULL, NULL, &item.width, &item.height);
@@ -39,9 +53,15 @@ Item item_init(SDL_Renderer *renderer, Item item, int x, int y) {
 }
 
 void item_cleanup(struct item *item) {
-    if (item->texture) {
-        SDL_DestroyTexture(item->texture);
-        item->texture = NULL;
+    item->texture = NULL;
+}
+
+void item_textures_cleanup(void) {
+    for (int i = 0; i < ITEM_TYPE_COUNT; i++) {
+        if (g_item_textures[i]) {
+            mem_track_texture_destroy(g_item_textures[i]);
+            g_item_textures[i] = NULL;
+        }
     }
 }
 
@@ -56,6 +76,7 @@ void item_use(Item *item, Player *player) {
         if (player->entity.health > PLAYER_MAX_HEALTH) {
             player->entity.health = PLAYER_MAX_HEALTH;
         }
+        ui_mark_hud_dirty();
         
         printf("Health Potion used! Heals for %d HP.\n", item->value);
         printf("Current Health: %d\n", player->entity.health);
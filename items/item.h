@@ -9,7 +9,8 @@ typedef enum
 {
     HEALTH_POTION,
     MANA_POTION,
-    ROCK
+    ROCK,
+    ITEM_TYPE_COUNT
 } ItemType;
 
 typedef struct item
@@ -22,8 +23,13 @@ typedef struct item
     int amount; // Für Stapelbarkeit, z.B. 3 Heiltränke
 } Item;
 
+// Textures are shared per type and live until item_textures_cleanup,
+// an Item only borrows its texture
 Item item_init(SDL_Renderer *renderer, Item item, int x, int y);
 void item_cleanup(Item *item);
 void item_use(Item *item, Player *player);
+// Texture of a type once item_init loaded it, NULL before
+SDL_Texture *item_texture(ItemType type);
+void item_textures_cleanup(void);
 
 #endif
\ No newline at end of file
@@ -11,23 +11,46 @@
 #include <unistd.h>
 
 #include "player/player.h"
+#include "items/item.h"
 #include "level/level.h"
 #include "level/levelHandler.h"
+#include "ui/ui.h"
+#include "texture/textureFormat.h"
+#include "texture/textureResidency.h"
+#include "assets/assetPack.h"
+#include "render/framePipeline.h"
+#include "render/qualityGovernor.h"
+#include "render/renderStats.h"
+#include "memory/memTrack.h"
+#include "input/input.h"
+#include "debug/perf.h"
 
 #define SCREEN_WIDTH 480
 #define SCREEN_HEIGHT 272
 
 int running = 1;
 
+// Everything the update step reads and writes; owned by the update thread between
+// frame_pipeline_begin and frame_pipeline_end
+typedef struct {
+    LevelHandler *level_handler;
+    Player *player;
+    InputState input;      // sampled by main before the update starts
+    FrameClock clock;
+    int game_state; // 0 = PLAYING, 1 = GAME OVER
+} GameFrame;
+
+static SDL_mutex *log_lock = NULL;
+
 SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path)
 {
-    SDL_Surface *pixels = IMG_Load(path);
+    SDL_Surface *pixels = IMG_Load_RW(asset_open(path), 1);
     if (!pixels)
     {
         fprintf(stderr, "ERROR IMG_Load: %s\n", IMG_GetError());
         return NULL;
     }
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, pixels);
+    SDL_Texture *texture = texture_create_from_surface(renderer, pixels, path);
     if (!texture)
         fprintf(stderr, "ERROR SDL_CreateTexture: %s\n", SDL_GetError());
     SDL_FreeSurface(pixels);
@@ -37,6 +60,8 @@ SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path)
 // --- Debug Logger ---
 void debug_log(const char *format, ...)
 {
+    // Update thread and main thread both log
+    if (log_lock) SDL_LockMutex(log_lock);
     // Wir erzwingen den Pfad auf den Memory Stick (Root)
     FILE *fp = fopen("ms0:/crash_log.txt", "a"); 
     if (fp)
@@ -48,6 +73,49 @@ void debug_log(const char *format, ...)
         fprintf(fp, "\n");
         fclose(fp);
     }
+    if (log_lock) SDL_UnlockMutex(log_lock);
+}
+
+// Pipeline step: game logic of one frame, then the render snapshot of the result
+static void game_update(void *ctx, RenderSnapshot *out)
+{
+    GameFrame *game = ctx;
+    Player *player = game->player;
+    Level *level = &game->level_handler->current_level;
+
+    if (game->game_state == 0) {
+        if (level->map.width > 0) {
+            int map_height = map_pixel_height(&level->map);
+            level_handler_update(game->level_handler, &game->input, &game->clock);
+
+            // Fall Death check - Nur wenn die Map eine Höhe hat!
+            if (map_height > 0 && player->entity.rect.y > map_height + 100) {
+                player_decrease_health(player, 1000, game->clock.tick);
+            }
+        }
+        if (player->entity.health <= 0) game->game_state = 1;
+    } else if (game->game_state == 1) {
+        if (input_pressed(&game->input, PSP_CTRL_START))
+        {
+            // Reset using the handler's current level
+            level_reset(level);
+            game->game_state = 0;
+        }
+    }
+
+    if (game->game_state == 0) {
+        level_handler_record(game->level_handler, out, &game->clock);
+    } else {
+        // Game Over screen only shows the player
+        int camera_x, camera_y;
+        level_get_camera(level, &camera_x, &camera_y);
+        render_snapshot_begin(out, camera_x, camera_y, game->clock.tick);
+        render_snapshot_subsystem(out, RENDER_SUB_PLAYER);
+        player_render(out, player, player->entity.vel_x != 0, camera_x, camera_y, game->clock.tick);
+        out->game_over = true;
+    }
+    // Input latency: a frame that reacts to a press carries the time of its sample
+    out->input_sampled_at = game->input.pressed ? game->input.sampled_at : 0;
 }
 
 // --- PSP Callbacks ---
@@ -81,12 +149,10 @@ int main(int argc, char *argv[])
     SDL_Window *window = NULL;
     SDL_Renderer *renderer = NULL;
     Player player = {0};
-
-    int game_state = 0; // 0 = PLAYING, 1 = GAME OVER
+    FramePipeline pipeline = {0};
 
     setup_callbacks();
-    sceCtrlSetSamplingCycle(0);
-    sceCtrlSetSamplingMode(PSP_CTRL_MODE_ANALOG);
+    input_init();
 
     chdir("disc0:/PSP_GAME/USRDIR/");
     sceKernelDelayThread(1000000); // 0,5 Sekunden warten (500ms)
@@ -94,6 +160,7 @@ int main(int argc, char *argv[])
     debug_log("Init SDL...");
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) < 0)
         goto cleanup;
+    log_lock = SDL_CreateMutex();
     if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
         goto cleanup;
 
@@ -114,87 +181,115 @@ int main(int argc, char *argv[])
         debug_log("Konnte Verzeichnis nicht wechseln!");
     }
 
+    asset_pack_init(ASSET_PACK_PATH);
+
+    // Mixer first, so player and level sounds can be loaded
+    audio_system_init();
     player = player_init(renderer);
 
     // Initialize the Handler
     LevelHandler level_handler = level_handler_init(renderer, &player);
 
-    SceCtrlData pad;
+    GameFrame game = { &level_handler, &player };
+    if (!frame_pipeline_init(&pipeline, game_update, &game))
+        goto cleanup;
+
+    PERF_TIMER(input_latency_timer);
+
+    Uint64 frame_start = SDL_GetPerformanceCounter();
+    Uint64 present_wait = 0;
 
     // --- GAME LOOP ---
     while (running) {
+        // The only clock read of the frame, everything below gets this tick
+        frame_clock_advance(&game.clock);
+
+        // Last frame against the budget; the update of this frame sees the new quality level
+        Uint64 now = SDL_GetPerformanceCounter();
+        quality_governor_frame(now - frame_start, present_wait);
+        frame_start = now;
+
         SDL_Event event;
         while (SDL_PollEvent(&event)) if (event.type == SDL_QUIT) running = 0;
 
-        sceCtrlReadBufferPositive(&pad, 1);
-        if (pad.Buttons & PSP_CTRL_SELECT) {
-            level_handler_change_level(&level_handler, 0);
+        // Never waits for vblank, the only wait of the frame is the vsync in SDL_RenderPresent
+        input_sample(&game.input, game.clock.tick);
+        if (input_pressed(&game.input, PSP_CTRL_SELECT)) {
+            level_handler_request_level(&level_handler, 0);
         }
 
-        int is_moving = (player.entity.vel_x != 0);
-
-        Level *level = &level_handler.current_level;
-
-        int map_pixel_width = level->map.tiled_map->width * level->map.tiled_map->tilewidth;
-        int map_pixel_height = level->map.tiled_map->height * level->map.tiled_map->tileheight;
-
-        int camera_x = player.entity.rect.x + (player.entity.rect.w / 2) - (SCREEN_WIDTH / 2);
-        int camera_y = player.entity.rect.y + (player.entity.rect.h / 2) - (SCREEN_HEIGHT / 2);
-
-        if (camera_x < 0) camera_x = 0;
-        if (camera_y < 0) camera_y = 0;
-        if (camera_x > map_pixel_width - SCREEN_WIDTH) camera_x = map_pixel_width - SCREEN_WIDTH;
-        if (camera_y > map_pixel_height - SCREEN_HEIGHT) camera_y = map_pixel_height - SCREEN_HEIGHT;
-        
-        if (game_state == 0) {
-            if (level && level->map.tiled_map) {
-                level_handler_update(&level_handler, &pad);
-
-            // Fall Death check - Nur wenn die Map eine Höhe hat!
-            if (map_pixel_height > 0 && player.entity.rect.y > map_pixel_height + 100) {
-                player_decrease_health(&player, 1000);
-            }
-        }
-            if (player.entity.health <= 0) game_state = 1;
-        } else if (game_state == 1) {
-            if (pad.Buttons & PSP_CTRL_START)
-            {
-                // Reset using the handler's current level
-                level_reset(&level_handler.current_level);
-                player.entity.health = PLAYER_MAX_HEALTH;
-                game_state = 0;
-            }
-        }
+        // Update of this frame runs while the snapshot of the previous one is drawn
+        frame_pipeline_begin(&pipeline);
 
         // --- Render ---
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        if (game_state == 0)
+        const RenderSnapshot *snap = frame_pipeline_front(&pipeline);
+        render_set_draw_color(renderer, RENDER_SUB_OTHER, 0, 0, 0, 255);
+        render_clear(renderer, RENDER_SUB_OTHER);
+        if (snap->valid && !snap->game_over)
         {
             // Render via Handler
-            level_handler_render(&level_handler, camera_x, camera_y);
+            level_handler_render(&level_handler, snap);
         }
-        else
+        else if (snap->valid)
         {
-            SDL_SetRenderDrawColor(renderer, 100, 0, 0, 255);
-            SDL_RenderClear(renderer);
-            // Render player manually on Game Over screen if needed
-            player_render(renderer, &player, is_moving, camera_x, camera_y);
+            render_set_draw_color(renderer, RENDER_SUB_OTHER, 100, 0, 0, 255);
+            render_clear(renderer, RENDER_SUB_OTHER);
+            render_snapshot_submit(renderer, snap);
         }
+#ifdef PERF_ENABLED
+        render_stats_overlay(renderer);
+#endif
+        Uint64 present_start = SDL_GetPerformanceCounter();
         SDL_RenderPresent(renderer);
+        present_wait = SDL_GetPerformanceCounter() - present_start;
+#ifdef PERF_ENABLED
+        // From the pad sample of a press to the first presented frame that reacts to it
+        if (snap->valid && snap->input_sampled_at) {
+            input_latency_timer.start = snap->input_sampled_at;
+            PERF_END(input_latency_timer);
+        }
+        render_stats_frame_end();
+#endif
+
+        frame_pipeline_end(&pipeline);
+
+        // Update is idle: level switches and music may use the renderer and the mixer
+        if (level_handler_sync(&level_handler)) {
+            frame_pipeline_invalidate(&pipeline);
+            // The load is not a frame the governor should react to
+            quality_governor_skip();
+        }
+        // Loads the clips hinted by this update, evicts what was not drawn for longest
+        texture_residency_update(renderer);
     }
 
     cleanup:
     debug_log("Cleaning up...");
-    audio_cleanup();
+    mem_track_report("Exit");
+    texture_residency_report("Exit");
+#ifdef PERF_ENABLED
+    render_stats_report("Exit");
+    render_stats_cleanup();
+#endif
+    frame_pipeline_cleanup(&pipeline);
+    ui_cleanup();
     level_handler_cleanup(&level_handler);
     player_cleanup(&player);
+    item_textures_cleanup();
+    // Music and chunks are freed above, the mixer goes last
+    audio_cleanup();
+    asset_pack_cleanup();
+    // Whatever is still live here leaked
+    mem_track_report("Nach Cleanup");
 
     if (renderer)
         SDL_DestroyRenderer(renderer);
     if (window)
         SDL_DestroyWindow(window);
     IMG_Quit();
+    if (log_lock)
+        SDL_DestroyMutex(log_lock);
+    log_lock = NULL;
     SDL_Quit();
     sceKernelExitGame();
     return 0;
@@ -1,5 +1,16 @@
+#include <stdlib.h>
+#include "../memory/arena.h"
+
+// Route the parser through the level arena when one is passed as mem_ctx.
+// Frees become no-ops there, the whole DOM goes away with arena_reset().
+#define CUTE_TILED_ALLOC(size, ctx) ((ctx) ? arena_alloc((Arena *)(ctx), MEM_TAG_TILED, (size)) : mem_alloc(MEM_TAG_TILED, (size)))
+#define CUTE_TILED_FREE(mem, ctx) do { if (!(ctx)) mem_free(mem); } while (0)
+
 #define CUTE_TILED_IMPLEMENTATION
 #include "map.h"
+#include "../texture/textureFormat.h"
+#include "../assets/assetPack.h"
+#include "../render/renderStats.h"
 #include <SDL_image.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,27 +20,26 @@ extern void debug_log(const char *format, ...);
 extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
 
 // Helper
-char* read_file_to_string(const char* path) {
-    FILE* file = fopen(path, "rb");
+char* read_file_to_string(const char* path, Arena* arena, long* out_size) {
+    SDL_RWops* file = asset_open(path);
     if (!file) {
         debug_log("FILE_ERROR: Konnte %s nicht oeffnen", path);
         return NULL;
     }
 
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    long size = (long)SDL_RWsize(file);
 
-    char* buffer = malloc(size + 1);
+    char* buffer = arena ? arena_alloc(arena, MEM_TAG_MAP, size + 1) : mem_alloc(MEM_TAG_MAP, size + 1);
     if (!buffer) {
         debug_log("MALLOC_ERROR: Kein Speicher fuer JSON-Buffer (%ld Bytes)", size);
-        fclose(file);
+        SDL_RWclose(file);
         return NULL;
     }
 
-    fread(buffer, 1, size, file);
+    SDL_RWread(file, buffer, 1, size);
     buffer[size] = '\0';
-    fclose(file);
+    SDL_RWclose(file);
+    if (out_size) *out_size = size;
     return buffer;
 }
 
@@ -76,20 +86,194 @@ int calculate_height(int shape, int ty, int offset_x) {
     }
 }
 
-int map_init(Map* map, SDL_Renderer* renderer, const char* path, const char** texture_paths, int texture_count) {
+// Tiles of the tileset image without a single transparent pixel
+static void map_mark_opaque_tiles(Map* map, SDL_Surface* surf, int firstgid) {
+    if (!map->opaque_gids) return;
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA8888, 0);
+    if (!rgba) return;
+
+    int tile_size = map->tile_size > 0 ? map->tile_size : 16;
+    int per_row = rgba->w / tile_size;
+    int rows = rgba->h / tile_size;
+    int opaque = 0;
+    SDL_LockSurface(rgba);
+    for (int t = 0; t < per_row * rows; t++) {
+        int gid = firstgid + t;
+        if (gid >= MAP_OPAQUE_GIDS) break;
+        bool solid = true;
+        for (int y = 0; y < tile_size && solid; y++) {
+            const Uint32* row = (const Uint32*)((const Uint8*)rgba->pixels + (size_t)((t / per_row) * tile_size + y) * rgba->pitch);
+            for (int x = 0; x < tile_size; x++) {
+                // RGBA8888: alpha in the low byte
+                if ((row[(t % per_row) * tile_size + x] & 0xFF) != 0xFF) { solid = false; break; }
+            }
+        }
+        if (solid) {
+            map->opaque_gids[gid >> 3] |= (Uint8)(1u << (gid & 7));
+            opaque++;
+        }
+    }
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+    debug_log("TILESET_OPAQUE: %d von %d Tiles deckend", opaque, per_row * rows);
+}
+
+static void map_load_tileset_texture(Map* map, SDL_Renderer* renderer, const char* path, int firstgid) {
+    int tex_idx = map->texture_count;
+    debug_log("TEXTURE_LOAD: Index %d, Pfad: %s", tex_idx, path);
+
+    // SDL_image Load
+    SDL_Surface* surf = IMG_Load_RW(asset_open(path), 1);
+    if (!surf) {
+        debug_log("IMG_ERROR: %s (Check Pfad/Leerzeichen/ISO!)", IMG_GetError());
+        map->textures[tex_idx] = NULL;
+    } else {
+        map_mark_opaque_tiles(map, surf, firstgid);
+        map->textures[tex_idx] = texture_create_from_surface(renderer, surf, path);
+        SDL_FreeSurface(surf);
+        if (!map->textures[tex_idx]) {
+            debug_log("SDL_ERROR: Texture Creation failed: %s", SDL_GetError());
+        } else {
+            debug_log("TEXTURE_SUCCESS: Geladen an Index %d", tex_idx);
+        }
+    }
+
+    map->tileset_firstgids[tex_idx] = firstgid;
+    map->texture_count++;
+}
+
+// <map>.chunks/ next to <map>.json, written by tools/split_map.py
+static MapStream* map_open_chunks(const char* path) {
+    char dir[MAP_STREAM_PATH_MAX];
+    const char* ext = strrchr(path, '.');
+    int len = ext ? (int)(ext - path) : (int)strlen(path);
+    snprintf(dir, sizeof(dir), "%.*s.chunks", len, path);
+    return map_stream_open(dir);
+}
+
+typedef struct {
+    Map* map;
+    Uint8* shapes;
+} MapShapeScan;
+
+static void map_store_shape(void* ctx, int gid, int tx, int ty) {
+    MapShapeScan* scan = ctx;
+    scan->shapes[ty * scan->map->width + tx] = (Uint8)get_tile_shape(scan->map, gid);
+}
+
+// Packed solid mask for sight and raycasts (width * height / 8 bytes) and the
+// navigation graph, both from one pass over the collision layer. Streamed maps
+// included, so they also cover chunks that are not resident.
+static void map_build_collision_data(Map* map) {
+    size_t tiles = (size_t)map->width * (size_t)map->height;
+    Uint8* shapes = mem_calloc(MEM_TAG_MAP, tiles ? tiles : 1, 1);
+    if (!shapes) {
+        debug_log("MALLOC_ERROR: Kein Speicher fuer Shape-Raster (%u Bytes)", (unsigned)tiles);
+        return;
+    }
+    MapShapeScan scan = { map, shapes };
+    map_for_each_collision_tile(map, map_store_shape, &scan);
+
+    map->solid_stride = (map->width + 31) / 32;
+    size_t words = (size_t)map->solid_stride * (size_t)map->height;
+    map->solid_bits = map->arena ? arena_calloc(map->arena, MEM_TAG_MAP, words, sizeof(Uint32))
+                                 : mem_calloc(MEM_TAG_MAP, words, sizeof(Uint32));
+    if (map->solid_bits) {
+        for (int ty = 0; ty < map->height; ty++) {
+            for (int tx = 0; tx < map->width; tx++) {
+                if (shapes[ty * map->width + tx] == SHAPE_SOLID) map->solid_bits[ty * map->solid_stride + (tx >> 5)] |= 1u << (tx & 31);
+            }
+        }
+        debug_log("SOLID_BITS: %dx%d Tiles, %u Bytes", map->width, map->height, (unsigned)(words * sizeof(Uint32)));
+    } else {
+        debug_log("MALLOC_ERROR: Kein Speicher fuer Solid-Bitset (%u Bytes)", (unsigned)(words * sizeof(Uint32)));
+    }
+
+    nav_build(&map->nav, shapes, map->width, map->height, map->tile_size, map->arena);
+    mem_free(shapes);
+}
+
+// Whole-map opacity mask of the DOM; streamed maps build one per chunk as it arrives
+static void map_build_opaque_bits(Map* map) {
+    if (!map->opaque_gids || map->width <= 0) return;
+    int stride = (map->width + 31) / 32;
+    size_t words = (size_t)stride * (size_t)map->height;
+    map->opaque_bits = map->arena ? arena_calloc(map->arena, MEM_TAG_MAP, words, sizeof(Uint32))
+                                  : mem_calloc(MEM_TAG_MAP, words, sizeof(Uint32));
+    if (!map->opaque_bits) return;
+
+    int covered = 0;
+    for (cute_tiled_layer_t* layer = map->tiled_map->layers; layer; layer = layer->next) {
+        if (strcmp(layer->name.ptr, "Collision") == 0 || strcmp(layer->type.ptr, "tilelayer") != 0) continue;
+        if (layer->width != map->width || layer->height != map->height) continue;
+        for (int i = 0; i < layer->data_count; i++) {
+            int gid = layer->data[i] & 0x1FFFFFFF;
+            if (!map_gid_opaque(map->opaque_gids, gid)) continue;
+            Uint32* word = &map->opaque_bits[(i / map->width) * stride + (i % map->width >> 5)];
+            Uint32 bit = 1u << (i % map->width & 31);
+            if (!(*word & bit)) covered++;
+            *word |= bit;
+        }
+    }
+    debug_log("OPAQUE_BITS: %d von %d Tiles verdecken den Hintergrund", covered, map->width * map->height);
+}
+
+static int map_init_streamed(Map* map, SDL_Renderer* renderer, MapStream* stream, const char** texture_paths, int texture_count) {
+    map->stream = stream;
+    // Filled by the tileset loads below, chunks are only published after map_init
+    stream->opaque_gids = map->opaque_gids;
+    map->width = stream->width;
+    map->height = stream->height;
+    map->tile_size = stream->tile_size;
+
+    // Same order as the DOM path: texture_paths belong to the non-collision tilesets
+    for (int i = 0; i < stream->tileset_count; i++) {
+        if (stream->tileset_collision[i]) {
+            map->collision_gid_start = (int)stream->tileset_firstgids[i];
+            debug_log("COLLISION_GID: Startet bei %d", map->collision_gid_start);
+        } else if (map->texture_count < texture_count && map->texture_count < MAX_TILESETS) {
+            map_load_tileset_texture(map, renderer, texture_paths[map->texture_count], (int)stream->tileset_firstgids[i]);
+        } else {
+            debug_log("TILESET_WARNING: Zu viele Tilesets oder Array-Limit erreicht.");
+        }
+    }
+
+    map_build_collision_data(map);
+    debug_log("--- MAP_INIT END (Chunks) ---");
+    return 1;
+}
+
+int map_init(Map* map, SDL_Renderer* renderer, const char* path, const char** texture_paths, int texture_count, Arena* arena) {
     debug_log("--- MAP_INIT START ---");
     debug_log("Pfad: %s", path);
 
+    map->arena = arena;
+    map->tiled_map = NULL;
+    map->collision_layer = NULL;
+    map->stream = NULL;
+    map->texture_count = 0;
+    map->collision_gid_start = 0;
+    map->solid_bits = NULL;
+    map->solid_stride = 0;
+    map->opaque_bits = NULL;
+    map->opaque_gids = arena ? arena_calloc(arena, MEM_TAG_MAP, MAP_OPAQUE_GIDS / 8, 1)
+                             : mem_calloc(MEM_TAG_MAP, MAP_OPAQUE_GIDS / 8, 1);
+
+    // Split maps are streamed, the JSON is only the fallback
+    MapStream* stream = map_open_chunks(path);
+    if (stream) return map_init_streamed(map, renderer, stream, texture_paths, texture_count);
+
     // 1. JSON laden
-    char* json_data = read_file_to_string(path);
+    long json_size = 0;
+    char* json_data = read_file_to_string(path, arena, &json_size);
     if (!json_data) {
         debug_log("MAP_ABORT: Datei-Lesefehler.");
         return -1;
     }
 
     // 2. Parsen mit cute_tiled
-    map->tiled_map = cute_tiled_load_map_from_memory(json_data, strlen(json_data), NULL);
-    free(json_data);
+    map->tiled_map = cute_tiled_load_map_from_memory(json_data, (int)json_size, arena);
+    if (!arena) mem_free(json_data);
 
     if (!map->tiled_map) {
         debug_log("MAP_ABORT: cute_tiled Parser-Fehler! (Check JSON Syntax)");
@@ -97,11 +281,12 @@ int map_init(Map* map, SDL_Renderer* renderer, const char* path, const char** te
     }
     debug_log("MAP_SUCCESS: JSON geparst. Groesse: %dx%d", map->tiled_map->width, map->tiled_map->height);
 
+    map->width = map->tiled_map->width;
+    map->height = map->tiled_map->height;
+    map->tile_size = map->tiled_map->tilewidth;
+
     // 3. Tilesets und Texturen verarbeiten
-    map->texture_count = 0;
-    map->collision_gid_start = 0;
     cute_tiled_tileset_t* ts = map->tiled_map->tilesets;
-    int tex_idx = 0;
 
     while (ts) {
         debug_log("TILESET_CHECK: Name='%s', FirstGID=%d, Count=%d", ts->name.ptr, ts->firstgid, ts->tilecount);
@@ -110,27 +295,8 @@ int map_init(Map* map, SDL_Renderer* renderer, const char* path, const char** te
             map->collision_gid_start = ts->firstgid;
             debug_log("COLLISION_GID: Startet bei %d", map->collision_gid_start);
         } else {
-            if (tex_idx < texture_count && tex_idx < MAX_TILESETS) {
-                debug_log("TEXTURE_LOAD: Index %d, Pfad: %s", tex_idx, texture_paths[tex_idx]);
-                
-                // SDL_image Load
-                SDL_Surface* surf = IMG_Load(texture_paths[tex_idx]);
-                if (!surf) {
-                    debug_log("IMG_ERROR: %s (Check Pfad/Leerzeichen/ISO!)", IMG_GetError());
-                    map->textures[tex_idx] = NULL;
-                } else {
-                    map->textures[tex_idx] = SDL_CreateTextureFromSurface(renderer, surf);
-                    SDL_FreeSurface(surf);
-                    if (!map->textures[tex_idx]) {
-                        debug_log("SDL_ERROR: Texture Creation failed: %s", SDL_GetError());
-                    } else {
-                        debug_log("TEXTURE_SUCCESS: Geladen an Index %d", tex_idx);
-                    }
-                }
-                
-                map->tileset_firstgids[tex_idx] = ts->firstgid;
-                map->texture_count++;
-                tex_idx++;
+            if (map->texture_count < texture_count && map->texture_count < MAX_TILESETS) {
+                map_load_tileset_texture(map, renderer, texture_paths[map->texture_count], ts->firstgid);
             } else {
                 debug_log("TILESET_WARNING: Zu viele Tilesets oder Array-Limit erreicht.");
             }
@@ -155,37 +321,56 @@ int map_init(Map* map, SDL_Renderer* renderer, const char* path, const char** te
         debug_log("MAP_WARNING: Kein 'Collision' Layer gefunden!");
     }
 
+    map_build_opaque_bits(map);
+
+    map_build_collision_data(map);
     debug_log("--- MAP_INIT END (Success) ---");
     return 1;
 }
 
-int map_is_solid(Map* map, int x, int y) {
+// The one place collision data is read, DOM layer or resident chunk
+static int map_collision_gid(Map* map, int tx, int ty) {
+    if (tx < 0 || tx >= map->width || ty < 0 || ty >= map->height) return 0;
+    if (map->stream) return map_stream_collision(map->stream, tx, ty);
     if (!map->collision_layer) return 0;
-    int tx = x / 16; int ty = y / 16;
-    if (tx < 0 || tx >= map->collision_layer->width || ty < 0 || ty >= map->collision_layer->height) return 0;
+    return map->collision_layer->data[ty * map->collision_layer->width + tx];
+}
+
+int map_is_solid(Map* map, int x, int y) {
+    return map_tile_solid(map, x / 16, y / 16);
+}
 
-    int id = map->collision_layer->data[ty * map->collision_layer->width + tx];
-    return (get_tile_shape(map, id) == SHAPE_SOLID); // Pass map
+int map_point_blocked(Map *map, int x, int y) {
+    int shape = map_get_shape_at(map, x, y);
+    switch (shape) {
+        case SHAPE_SOLID:
+            return 1;
+        case SHAPE_SLOPE_45_UP:
+        case SHAPE_SLOPE_45_DOWN:
+        case SHAPE_HALF_UP_1:
+        case SHAPE_HALF_UP_2:
+        case SHAPE_HALF_DOWN_1:
+        case SHAPE_HALF_DOWN_2:
+            // below the surface of the slope / half tile
+            return y >= calculate_height(shape, y / 16, x % 16);
+        default:
+            return 0;
+    }
 }
 
 int map_get_shape_at(Map *map, int x, int y) {
-    if (!map->collision_layer) return SHAPE_EMPTY;
-    int tx = x / 16; int ty = y / 16;
-    if (tx < 0 || tx >= map->collision_layer->width || ty < 0 || ty >= map->collision_layer->height) return SHAPE_EMPTY;
-    int id = map->collision_layer->data[ty * map->collision_layer->width + tx];
+    int id = map_collision_gid(map, x / 16, y / 16);
     return get_tile_shape(map, id); // Pass map
 }
 
 int map_get_floor_height(Map* map, int x, int y) {
-    if (!map->collision_layer) return -1;
     int tx = x / 16; int ty = y / 16; int offset_x = x % 16;
     int best_height = -1;
 
     for (int check_y = ty - 1; check_y <= ty + 1; check_y++) {
-        if (check_y < 0 || check_y >= map->collision_layer->height) continue;
+        if (check_y < 0 || check_y >= map->height) continue;
 
-        int index = (check_y * map->collision_layer->width) + tx;
-        int id = map->collision_layer->data[index];
+        int id = map_collision_gid(map, tx, check_y);
         int shape = get_tile_shape(map, id); // Pass map
 
         if (shape == SHAPE_EMPTY) continue;
@@ -198,7 +383,51 @@ int map_get_floor_height(Map* map, int x, int y) {
     return best_height;
 }
 
+static void map_render_tile(SDL_Renderer *renderer, Map *map, int tile_id, int px, int py, int camera_x, int camera_y) {
+    // Find correct texture based on GID range
+    int t_idx = -1;
+    for (int t = map->texture_count - 1; t >= 0; t--) {
+        if (tile_id >= map->tileset_firstgids[t]) { t_idx = t; break; }
+    }
+
+    if (t_idx == -1 || !map->textures[t_idx]) return;
+
+    int firstgid = map->tileset_firstgids[t_idx];
+    int gid = (tile_id & 0x1FFFFFFF) - firstgid;
+    int img_w, img_h; SDL_QueryTexture(map->textures[t_idx], NULL, NULL, &img_w, &img_h);
+    int tile_size = 16; int tiles_per_row = img_w / tile_size;
+
+    SDL_Rect src = { (gid % tiles_per_row) * tile_size, (gid / tiles_per_row) * tile_size, tile_size, tile_size };
+    SDL_Rect dest = { px - camera_x, py - camera_y, tile_size, tile_size };
+    render_copy(renderer, RENDER_SUB_MAP, map->textures[t_idx], &src, &dest);
+}
+
+// Only the tiles under the view, looked up in the resident chunks
+static void map_render_streamed(SDL_Renderer *renderer, Map *map, int camera_x, int camera_y) {
+    int tile_size = map->tile_size;
+    int tx0 = SDL_max(camera_x / tile_size, 0);
+    int ty0 = SDL_max(camera_y / tile_size, 0);
+    int tx1 = SDL_min((camera_x + 480) / tile_size, map->width - 1);
+    int ty1 = SDL_min((camera_y + 272) / tile_size, map->height - 1);
+
+    for (int layer = 0; layer < map->stream->layer_count; layer++) {
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                const Uint16 *plane = map_stream_layer(map->stream, tx / MAP_CHUNK_TILES, ty / MAP_CHUNK_TILES, layer);
+                if (!plane) continue;
+                int tile_id = plane[(ty % MAP_CHUNK_TILES) * MAP_CHUNK_TILES + tx % MAP_CHUNK_TILES];
+                if (tile_id == 0) continue;
+                map_render_tile(renderer, map, tile_id, tx * tile_size, ty * tile_size, camera_x, camera_y);
+            }
+        }
+    }
+}
+
 void map_render(SDL_Renderer *renderer, Map *map, int camera_x, int camera_y) {
+    if (map->stream) {
+        map_render_streamed(renderer, map, camera_x, camera_y);
+        return;
+    }
     if (!map->tiled_map) return;
     cute_tiled_layer_t* layer = map->tiled_map->layers;
 
@@ -210,32 +439,107 @@ void map_render(SDL_Renderer *renderer, Map *map, int camera_x, int camera_y) {
             for (int i = 0; i < count; i++) {
                 int tile_id = tiles[i]; if (tile_id == 0) continue;
 
-                // Find correct texture based on GID range
-                int t_idx = -1;
-                for (int t = map->texture_count - 1; t >= 0; t--) {
-                    if (tile_id >= map->tileset_firstgids[t]) { t_idx = t; break; }
-                }
-
-                if (t_idx == -1 || !map->textures[t_idx]) continue;
-
-                int firstgid = map->tileset_firstgids[t_idx];
-                int gid = (tile_id & 0x1FFFFFFF) - firstgid;
-                int img_w, img_h; SDL_QueryTexture(map->textures[t_idx], NULL, NULL, &img_w, &img_h);
-                int tile_size = 16; int tiles_per_row = img_w / tile_size;
-
+                int tile_size = 16;
                 int px = (i % width) * tile_size; int py = (i / width) * tile_size;
                 if (px - camera_x < -tile_size || px - camera_x > 480 || py - camera_y < -tile_size || py - camera_y > 272) continue;
 
-                SDL_Rect src = { (gid % tiles_per_row) * tile_size, (gid / tiles_per_row) * tile_size, tile_size, tile_size };
-                SDL_Rect dest = { px - camera_x, py - camera_y, tile_size, tile_size };
-                SDL_RenderCopy(renderer, map->textures[t_idx], &src, &dest);
+                map_render_tile(renderer, map, tile_id, px, py, camera_x, camera_y);
             }
         }
         layer = layer->next;
     }
 }
 
+int map_tile_opaque(const Map *map, int tx, int ty) {
+    if (tx < 0 || tx >= map->width || ty < 0 || ty >= map->height) return 0;
+    if (map->stream) return map_stream_opaque(map->stream, tx, ty);
+    if (!map->opaque_bits) return 0;
+    return (int)(map->opaque_bits[ty * ((map->width + 31) / 32) + (tx >> 5)] >> (tx & 31) & 1u);
+}
+
+int map_uncovered_rects(const Map *map, int camera_x, int camera_y, int view_w, int view_h, SDL_Rect *rects, int max) {
+    int ts = map->tile_size;
+    if (ts <= 0) return -1;
+    int count = 0;
+    int prev_first = 0, prev_count = 0;
+
+    // One band per tile row on screen, runs of uncovered tiles in it; a band with
+    // the same runs as the one above extends those rects instead of adding new ones
+    for (int ty = camera_y / ts; ty * ts - camera_y < view_h; ty++) {
+        int top = SDL_max(ty * ts - camera_y, 0);
+        int bottom = SDL_min((ty + 1) * ts - camera_y, view_h);
+        int first = count;
+        SDL_Rect runs[MAP_UNCOVERED_RUNS_MAX];
+        int run_count = 0;
+
+        for (int tx = camera_x / ts; tx * ts - camera_x < view_w; tx++) {
+            if (map_tile_opaque(map, tx, ty)) continue;
+            int left = SDL_max(tx * ts - camera_x, 0);
+            int right = SDL_min((tx + 1) * ts - camera_x, view_w);
+            if (run_count > 0 && runs[run_count - 1].x + runs[run_count - 1].w == left) {
+                runs[run_count - 1].w = right - runs[run_count - 1].x;
+            } else {
+                if (run_count == MAP_UNCOVERED_RUNS_MAX) return -1;
+                runs[run_count++] = (SDL_Rect){ left, top, right - left, bottom - top };
+            }
+        }
+
+        bool same = run_count == prev_count && run_count > 0;
+        for (int r = 0; same && r < run_count; r++) {
+            same = rects[prev_first + r].x == runs[r].x && rects[prev_first + r].w == runs[r].w;
+        }
+        if (same) {
+            for (int r = 0; r < run_count; r++) rects[prev_first + r].h = bottom - rects[prev_first + r].y;
+            continue;
+        }
+        if (count + run_count > max) return -1;
+        for (int r = 0; r < run_count; r++) rects[count++] = runs[r];
+        prev_first = first;
+        prev_count = run_count;
+    }
+    return count;
+}
+
+int map_pixel_width(const Map *map) {
+    return map->width * map->tile_size;
+}
+
+int map_pixel_height(const Map *map) {
+    return map->height * map->tile_size;
+}
+
+void map_for_each_collision_tile(Map *map, MapStreamVisitor visit, void *ctx) {
+    if (map->stream) {
+        map_stream_scan(map->stream, visit, ctx);
+        return;
+    }
+    cute_tiled_layer_t* col = map->collision_layer;
+    if (!col) return;
+    for (int i = 0; i < col->width * col->height; i++) {
+        if (col->data[i] > 0) visit(ctx, col->data[i], i % col->width, i / col->width);
+    }
+}
+
 void map_cleanup(Map *map) {
-    if (map->tiled_map) cute_tiled_free_map(map->tiled_map);
-    for (int i = 0; i < MAX_TILESETS; i++) if (map->textures[i]) SDL_DestroyTexture(map->textures[i]);
+    // Arena maps are dropped as a whole by the level arena reset
+    if (map->tiled_map && !map->arena) cute_tiled_free_map(map->tiled_map);
+    map->tiled_map = NULL;
+    map->collision_layer = NULL;
+    if (map->solid_bits && !map->arena) mem_free(map->solid_bits);
+    map->solid_bits = NULL;
+    nav_free(&map->nav);
+    map_stream_close(map->stream);
+    map->stream = NULL;
+    if (!map->arena) {
+        mem_free(map->opaque_gids);
+        mem_free(map->opaque_bits);
+    }
+    map->opaque_gids = NULL;
+    map->opaque_bits = NULL;
+    map->width = 0;
+    map->height = 0;
+    for (int i = 0; i < MAX_TILESETS; i++) {
+        if (map->textures[i]) mem_track_texture_destroy(map->textures[i]);
+        map->textures[i] = NULL;
+    }
 }
\ No newline at end of file
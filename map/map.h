@@ -3,6 +3,8 @@
 
 #include <SDL.h>
 #include "cute_tiled.h"
+#include "mapStream.h"
+#include "mapNav.h"
 
 // Shapes
 #define SHAPE_EMPTY 0
@@ -22,22 +24,58 @@
 #define SHAPE_CHEST 14
 
 #define MAX_TILESETS 8
+// Uncovered runs in one tile row of the view before map_uncovered_rects gives up
+#define MAP_UNCOVERED_RUNS_MAX 16
 
+struct Arena;
+
+/*
+ * A map is either one cute_tiled DOM or, if tools/split_map.py produced
+ * <map>.chunks/ next to the JSON, streamed chunk by chunk (map/mapStream.h).
+ * Collision queries and map_render work the same on both.
+ */
 typedef struct Map {
-    cute_tiled_map_t* tiled_map;
+    cute_tiled_map_t* tiled_map;          // NULL bei gestreamten Maps
     cute_tiled_layer_t* collision_layer;
+    MapStream* stream;                    // NULL = ganze Map im DOM
+    int width, height;                    // in Tiles
+    int tile_size;
     SDL_Texture* textures[MAX_TILESETS];
     int tileset_firstgids[MAX_TILESETS];
     int texture_count;
     int collision_gid_start;
+    Uint32* solid_bits;                   // 1 Bit pro Tile (SHAPE_SOLID), Zeilen zu solid_stride Words
+    int solid_stride;
+    NavGraph nav;                         // Laufflaechen und Verbindungen fuer die Gegner-KI
+    Uint8* opaque_gids;                   // 1 Bit pro GID (MAP_OPAQUE_GIDS): Tile komplett deckend
+    Uint32* opaque_bits;                  // nur DOM: Tile von einem deckenden Tile verdeckt (solid_stride)
+    struct Arena* arena;   // Besitzer von JSON und DOM, NULL = malloc
 } Map;
 
 // Functions
-int map_init(Map *map, SDL_Renderer *renderer, const char *json_path, const char** texture_paths, int texture_count);
+int map_init(Map *map, SDL_Renderer *renderer, const char *json_path, const char** texture_paths, int texture_count, struct Arena *arena);
 int map_get_shape_at(Map *map, int x, int y);
 int map_get_floor_height(Map* map, int x, int y);
 int map_is_solid(Map* map, int x, int y);
+
+// Solid bit of tile (tx, ty), 0 outside the map; built once by map_init, also for non-resident chunks
+static inline int map_tile_solid(const Map *map, int tx, int ty) {
+    if ((unsigned)tx >= (unsigned)map->width || (unsigned)ty >= (unsigned)map->height || !map->solid_bits) return 0;
+    return (int)((map->solid_bits[ty * map->solid_stride + (tx >> 5)] >> (tx & 31)) & 1u);
+}
+
+// Point test against the Collision shapes, slopes and half tiles included
+int map_point_blocked(Map *map, int x, int y);
 void map_render(SDL_Renderer *renderer, Map *map, int camera_x, int camera_y);
+// Tile (tx, ty) is covered by an opaque tile of some render layer, nothing behind it shows
+int map_tile_opaque(const Map *map, int tx, int ty);
+// Parts of the view_w x view_h view (screen coordinates) not covered by opaque tiles, merged
+// into at most max rects; -1 if it takes more, the caller then draws the whole view
+int map_uncovered_rects(const Map *map, int camera_x, int camera_y, int view_w, int view_h, SDL_Rect *rects, int max);
+int map_pixel_width(const Map *map);
+int map_pixel_height(const Map *map);
+// Every non-empty tile of the Collision layer (spawn markers included), streamed maps chunk by chunk
+void map_for_each_collision_tile(Map *map, MapStreamVisitor visit, void *ctx);
 void map_cleanup(Map *map);
 int get_tile_shape(Map* map, int tile_id);
 
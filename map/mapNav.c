@@ -0,0 +1,249 @@
+#include "mapNav.h"
+#include <string.h>
+#include "map.h"
+#include "../memory/arena.h"
+
+extern void debug_log(const char *format, ...);
+
+#define NAV_SPANS_MAX 0xFFFF
+
+typedef struct {
+    const Uint8 *shapes;
+    int width, height;
+    NavGraph *nav;
+    NavLink *links;        // growing scratch, copied into the graph at the end
+    int link_count, link_capacity;
+} NavBuilder;
+
+static int nav_shape(const NavBuilder *b, int tx, int ty) {
+    if (tx < 0 || tx >= b->width || ty < 0 || ty >= b->height) return SHAPE_EMPTY;
+    return b->shapes[ty * b->width + tx];
+}
+
+static bool nav_is_floor(int shape) {
+    return shape == SHAPE_SOLID || shape == SHAPE_PLATFORM || (shape >= SHAPE_SLOPE_45_UP && shape <= SHAPE_HALF_DOWN_2);
+}
+
+// Blocks a body: solid tiles and the filled part of slopes and half tiles
+static bool nav_is_blocking(int shape) {
+    return shape == SHAPE_SOLID || (shape >= SHAPE_SLOPE_45_UP && shape <= SHAPE_HALF_DOWN_2);
+}
+
+static bool nav_is_walkable(const NavBuilder *b, int tx, int ty) {
+    return nav_is_floor(nav_shape(b, tx, ty)) && !nav_is_blocking(nav_shape(b, tx, ty - 1));
+}
+
+static void *nav_alloc(NavGraph *nav, size_t count, size_t size) {
+    return nav->arena ? arena_calloc(nav->arena, MEM_TAG_MAP, count, size) : mem_calloc(MEM_TAG_MAP, count, size);
+}
+
+int nav_span_at(const NavGraph *nav, int tx, int ty) {
+    if (ty < 0 || ty >= nav->height || !nav->row_begin) return -1;
+    // Binary search in the row, spans are sorted by x
+    int lo = nav->row_begin[ty], hi = nav->row_begin[ty + 1] - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const NavSpan *s = &nav->spans[mid];
+        if (tx < s->tx0) hi = mid - 1;
+        else if (tx > s->tx1) lo = mid + 1;
+        else return mid;
+    }
+    return -1;
+}
+
+int nav_span_under(const NavGraph *nav, int x, int feet_y) {
+    if (nav->tile_size <= 0 || x < 0 || feet_y < 0) return -1;
+    int tx = x / nav->tile_size, ty = feet_y / nav->tile_size;
+    // Standing on a full tile puts the feet on the top edge of its row, on a
+    // slope inside it; a pixel above the surface still counts as standing
+    int span = nav_span_at(nav, tx, ty);
+    if (span < 0) span = nav_span_at(nav, tx, ty + 1);
+    return span;
+}
+
+static void nav_add_link(NavBuilder *b, int from, int to, NavLinkType type, int dir) {
+    if (to < 0 || to == from) return;
+    // One link per target, the cheapest kind found first wins
+    for (int l = b->nav->link_begin[from]; l < b->link_count; l++) {
+        if (b->links[l].to == to) return;
+    }
+    if (b->link_count == b->link_capacity) {
+        int capacity = b->link_capacity ? b->link_capacity * 2 : 256;
+        NavLink *grown = mem_alloc(MEM_TAG_MAP, (size_t)capacity * sizeof(NavLink));
+        if (!grown) return;
+        if (b->links) memcpy(grown, b->links, (size_t)b->link_count * sizeof(NavLink));
+        mem_free(b->links);
+        b->links = grown;
+        b->link_capacity = capacity;
+    }
+    b->links[b->link_count++] = (NavLink){ (Uint16)from, (Uint16)to, (Uint8)type, (Sint8)dir };
+}
+
+// Links over one end of span s: steps and slopes, drops down the open column
+// next to it and jumps onto spans up to NAV_JUMP_RISE rows higher
+static void nav_link_side(NavBuilder *b, int s, int dir) {
+    const NavGraph *nav = b->nav;
+    const NavSpan *span = &nav->spans[s];
+    int row = span->row;
+    int edge = dir > 0 ? span->tx1 : span->tx0;
+    int c = edge + dir;
+    if (c < 0 || c >= b->width) return;
+
+    // Walk: one row up or down in the next column (entity_move_and_collide steps up to 24 px)
+    nav_add_link(b, s, nav_span_at(nav, c, row - 1), NAV_WALK, dir);
+    nav_add_link(b, s, nav_span_at(nav, c, row + 1), NAV_WALK, dir);
+
+    // Drop: the next column is open at body height, fall onto the first floor below
+    if (!nav_is_floor(nav_shape(b, c, row)) && !nav_is_blocking(nav_shape(b, c, row - 1))) {
+        for (int y = row + 1; y < b->height; y++) {
+            if (!nav_is_floor(nav_shape(b, c, y))) continue;
+            nav_add_link(b, s, nav_span_at(nav, c, y), y == row + 1 ? NAV_WALK : NAV_DROP, dir);
+            break;
+        }
+    }
+
+    // Jump: needs head room above the end tile for the whole rise
+    for (int rise = 0; rise <= NAV_JUMP_RISE; rise++) {
+        if (nav_is_blocking(nav_shape(b, edge, row - 2 - rise))) break;
+        for (int gap = rise == 0 ? 1 : 0; gap <= NAV_JUMP_GAP; gap++) {
+            int target = nav_span_at(nav, c + dir * gap, row - rise);
+            if (target < 0) continue;
+            nav_add_link(b, s, target, NAV_JUMP, dir);
+            break;
+        }
+    }
+}
+
+bool nav_build(NavGraph *nav, const Uint8 *shapes, int width, int height, int tile_size, Arena *arena) {
+    Uint32 version = nav->version + 1;
+    memset(nav, 0, sizeof(*nav));
+    nav->arena = arena;
+    nav->tile_size = tile_size;
+    nav->height = height;
+    nav->version = version;
+    nav->flow_goal = -1;
+    if (width <= 0 || height <= 0) return false;
+
+    NavBuilder b = { shapes, width, height, nav, NULL, 0, 0 };
+
+    // 1. Spans, counted first so they go into one array
+    int count = 0;
+    for (int ty = 0; ty < height; ty++) {
+        for (int tx = 0; tx < width; tx++) {
+            if (nav_is_walkable(&b, tx, ty) && !nav_is_walkable(&b, tx - 1, ty)) count++;
+        }
+    }
+    if (count > NAV_SPANS_MAX) {
+        debug_log("NAV: %d Spans, mehr als %d, kein Navigationsgraph", count, NAV_SPANS_MAX);
+        return false;
+    }
+
+    nav->spans = nav_alloc(nav, (size_t)(count ? count : 1), sizeof(NavSpan));
+    nav->row_begin = nav_alloc(nav, (size_t)height + 1, sizeof(int));
+    nav->link_begin = nav_alloc(nav, (size_t)count + 1, sizeof(int));
+    nav->in_begin = nav_alloc(nav, (size_t)count + 1, sizeof(int));
+    nav->flow_next = nav_alloc(nav, (size_t)(count ? count : 1), sizeof(int));
+    nav->flow_hops = nav_alloc(nav, (size_t)(count ? count : 1), sizeof(Uint16));
+    nav->queue = nav_alloc(nav, (size_t)(count ? count : 1), sizeof(int));
+    if (!nav->spans || !nav->row_begin || !nav->link_begin || !nav->in_begin || !nav->flow_next || !nav->flow_hops || !nav->queue) {
+        debug_log("NAV: Kein Speicher fuer %d Spans", count);
+        nav_free(nav);
+        return false;
+    }
+
+    for (int ty = 0; ty < height; ty++) {
+        nav->row_begin[ty] = nav->span_count;
+        for (int tx = 0; tx < width; tx++) {
+            if (!nav_is_walkable(&b, tx, ty)) continue;
+            int start = tx;
+            while (tx + 1 < width && nav_is_walkable(&b, tx + 1, ty)) tx++;
+            nav->spans[nav->span_count++] = (NavSpan){ (Uint16)ty, (Uint16)start, (Uint16)tx };
+        }
+    }
+    nav->row_begin[height] = nav->span_count;
+
+    // 2. Links, grouped by source span
+    for (int s = 0; s < nav->span_count; s++) {
+        nav->link_begin[s] = b.link_count;
+        nav_link_side(&b, s, -1);
+        nav_link_side(&b, s, 1);
+    }
+    nav->link_begin[nav->span_count] = b.link_count;
+
+    nav->link_count = b.link_count;
+    nav->links = nav_alloc(nav, (size_t)(b.link_count ? b.link_count : 1), sizeof(NavLink));
+    nav->in_links = nav_alloc(nav, (size_t)(b.link_count ? b.link_count : 1), sizeof(int));
+    if (!nav->links || !nav->in_links) {
+        debug_log("NAV: Kein Speicher fuer %d Links", b.link_count);
+        mem_free(b.links);
+        nav_free(nav);
+        return false;
+    }
+    if (b.link_count) memcpy(nav->links, b.links, (size_t)b.link_count * sizeof(NavLink));
+    mem_free(b.links);
+
+    // 3. Incoming links for the reverse search
+    int walk = 0, drop = 0, jump = 0;
+    for (int l = 0; l < nav->link_count; l++) {
+        nav->in_begin[nav->links[l].to + 1]++;
+        if (nav->links[l].type == NAV_WALK) walk++;
+        else if (nav->links[l].type == NAV_DROP) drop++;
+        else jump++;
+    }
+    for (int s = 0; s < nav->span_count; s++) nav->in_begin[s + 1] += nav->in_begin[s];
+    int *fill = nav->queue;  // free until the first flow update
+    memcpy(fill, nav->in_begin, (size_t)nav->span_count * sizeof(int));
+    for (int l = 0; l < nav->link_count; l++) nav->in_links[fill[nav->links[l].to]++] = l;
+
+    debug_log("NAV: %d Spans, %d Links (%d Laufen, %d Fallen, %d Springen)",
+              nav->span_count, nav->link_count, walk, drop, jump);
+    return true;
+}
+
+void nav_flow_update(NavGraph *nav, int goal) {
+    if (goal < 0 || goal >= nav->span_count) return;
+    if (goal == nav->flow_goal && nav->flow_version == nav->version) return;
+
+    for (int s = 0; s < nav->span_count; s++) {
+        nav->flow_next[s] = -1;
+        nav->flow_hops[s] = NAV_UNREACHABLE;
+    }
+
+    // Breadth-first from the goal backwards along the links
+    int head = 0, tail = 0;
+    nav->flow_hops[goal] = 0;
+    nav->queue[tail++] = goal;
+    while (head < tail) {
+        int t = nav->queue[head++];
+        for (int k = nav->in_begin[t]; k < nav->in_begin[t + 1]; k++) {
+            int l = nav->in_links[k];
+            int from = nav->links[l].from;
+            if (nav->flow_hops[from] != NAV_UNREACHABLE) continue;
+            nav->flow_hops[from] = (Uint16)(nav->flow_hops[t] + 1);
+            nav->flow_next[from] = l;
+            nav->queue[tail++] = from;
+        }
+    }
+
+    nav->flow_goal = goal;
+    nav->flow_version = nav->version;
+    nav->flow_rebuilds++;
+}
+
+void nav_free(NavGraph *nav) {
+    if (!nav->arena) {
+        mem_free(nav->spans);
+        mem_free(nav->row_begin);
+        mem_free(nav->links);
+        mem_free(nav->link_begin);
+        mem_free(nav->in_links);
+        mem_free(nav->in_begin);
+        mem_free(nav->flow_next);
+        mem_free(nav->flow_hops);
+        mem_free(nav->queue);
+    }
+    Uint32 version = nav->version;
+    memset(nav, 0, sizeof(*nav));
+    nav->version = version;
+    nav->flow_goal = -1;
+}
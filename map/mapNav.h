@@ -0,0 +1,83 @@
+#ifndef MAP_NAV_H
+#define MAP_NAV_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+struct Arena;
+
+// Jump links an enemy can make with ENEMY_JUMP_SPEED (enemies/enemy.h) under gravity 0.4:
+// up to NAV_JUMP_RISE tile rows up and NAV_JUMP_GAP tiles across
+#define NAV_JUMP_RISE 2
+#define NAV_JUMP_GAP 2
+#define NAV_UNREACHABLE 0xFFFF
+
+typedef enum {
+    NAV_WALK,      // next span continues the floor, one step or slope up or down
+    NAV_DROP,      // off the end of the span, falling onto the target
+    NAV_JUMP       // from the end tile of the span
+} NavLinkType;
+
+// Walkable floor tiles in one row: solid, platform, slope or half tile with no solid tile above
+typedef struct {
+    Uint16 row;
+    Uint16 tx0, tx1;       // inclusive
+} NavSpan;
+
+typedef struct {
+    Uint16 from, to;       // span indices
+    Uint8 type;            // NavLinkType
+    Sint8 dir;             // -1 leaves over the left end of the span, +1 over the right end
+} NavLink;
+
+/*
+ * Navigation graph of the collision shapes, built once by map_init: nodes are
+ * floor spans, links the ways from one span to another. Spans are stored row
+ * by row in ascending x, links grouped by their source span.
+ *
+ * Path queries go through one flow field towards a goal span (the player's):
+ * a reverse breadth-first search that tells every span which link to take
+ * next. It is recomputed only when the goal or the graph version changes, so
+ * any number of enemies follow it with a table lookup each.
+ */
+typedef struct NavGraph {
+    int tile_size;
+    int height;            // rows of the map
+    NavSpan *spans;
+    int span_count;
+    int *row_begin;        // [height + 1] first span of every row
+    NavLink *links;
+    int link_count;
+    int *link_begin;       // [span_count + 1] outgoing links of every span
+    int *in_links;         // link indices grouped by target span
+    int *in_begin;         // [span_count + 1]
+    Uint32 version;        // bumped by every build
+
+    int flow_goal;         // -1 = none yet
+    Uint32 flow_version;
+    int *flow_next;        // [span_count] link towards the goal, -1 at the goal or when unreachable
+    Uint16 *flow_hops;     // [span_count] links to the goal, NAV_UNREACHABLE
+    int *queue;            // [span_count] search scratch
+    int flow_rebuilds;
+
+    struct Arena *arena;   // owner of the arrays, NULL = malloc
+} NavGraph;
+
+// shapes: width * height SHAPE_* of the collision layer
+bool nav_build(NavGraph *nav, const Uint8 *shapes, int width, int height, int tile_size, struct Arena *arena);
+void nav_free(NavGraph *nav);
+
+// Span at tile (tx, ty), -1 if that tile is not walkable floor
+int nav_span_at(const NavGraph *nav, int tx, int ty);
+// Span under a pixel position of the feet (bottom centre of a hitbox), -1 while in the air
+int nav_span_under(const NavGraph *nav, int x, int feet_y);
+// Points the flow field at goal, recomputed only if the goal or the graph changed
+void nav_flow_update(NavGraph *nav, int goal);
+
+// Link to take from span towards the flow goal, NULL at the goal or if it cannot be reached
+static inline const NavLink *nav_flow_link(const NavGraph *nav, int span) {
+    if (span < 0 || nav->flow_goal < 0 || nav->flow_next[span] < 0) return NULL;
+    return &nav->links[nav->flow_next[span]];
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "mapRaycast.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+extern void debug_log(const char *format, ...);
+
+bool map_raycast(const Map *map, float x0, float y0, float x1, float y1, MapRayHit *hit) {
+    int ts = map->tile_size;
+    if (!map->solid_bits || ts <= 0) return false;
+
+    int tx = (int)floorf(x0 / ts), ty = (int)floorf(y0 / ts);
+    int end_tx = (int)floorf(x1 / ts), end_ty = (int)floorf(y1 / ts);
+    float dx = x1 - x0, dy = y1 - y0;
+    int step_x = dx > 0 ? 1 : -1;
+    int step_y = dy > 0 ? 1 : -1;
+
+    // Segment parameter t in [0, 1] at the next vertical / horizontal tile border
+    float t_delta_x = dx != 0 ? ts / fabsf(dx) : FLT_MAX;
+    float t_delta_y = dy != 0 ? ts / fabsf(dy) : FLT_MAX;
+    float t_max_x = dx > 0 ? ((tx + 1) * ts - x0) / dx : dx < 0 ? (tx * ts - x0) / dx : FLT_MAX;
+    float t_max_y = dy > 0 ? ((ty + 1) * ts - y0) / dy : dy < 0 ? (ty * ts - y0) / dy : FLT_MAX;
+
+    float t = 0.0f;
+    int steps = abs(end_tx - tx) + abs(end_ty - ty);
+    for (;;) {
+        if (map_tile_solid(map, tx, ty)) {
+            if (hit) {
+                hit->tile_x = tx;
+                hit->tile_y = ty;
+                hit->x = x0 + dx * t;
+                hit->y = y0 + dy * t;
+                hit->distance = t * sqrtf(dx * dx + dy * dy);
+            }
+            return true;
+        }
+        if (steps-- == 0) return false;
+        if (t_max_x < t_max_y) {
+            t = t_max_x;
+            t_max_x += t_delta_x;
+            tx += step_x;
+        } else {
+            t = t_max_y;
+            t_max_y += t_delta_y;
+            ty += step_y;
+        }
+    }
+}
+
+void map_raycast_benchmark(const Map *map, int queries) {
+    int world_w = map->width * map->tile_size;
+    int world_h = map->height * map->tile_size;
+    if (world_w <= 0 || world_h <= 0 || queries <= 0) return;
+
+    // Fixed seed so runs are comparable
+    Uint32 seed = 0x2545F491u;
+    int blocked = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int q = 0; q < queries; q++) {
+        float c[4];
+        for (int k = 0; k < 4; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            c[k] = (float)(seed >> 8) / (float)(1u << 24);
+        }
+        float x0 = c[0] * world_w, y0 = c[1] * world_h;
+        float x1 = x0 + (c[2] - 0.5f) * 2.0f * 480.0f;
+        float y1 = y0 + (c[3] - 0.5f) * 2.0f * 272.0f;
+        if (map_raycast(map, x0, y0, x1, y1, NULL)) blocked++;
+    }
+    double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+    debug_log("RAYCAST: %d Abfragen in %.2f ms, %.0f pro Sekunde, %d%% blockiert",
+              queries, ms, ms > 0.0 ? queries * 1000.0 / ms : 0.0, blocked * 100 / queries);
+}
@@ -0,0 +1,28 @@
+#ifndef MAP_RAYCAST_H
+#define MAP_RAYCAST_H
+
+#include <stdbool.h>
+#include "map.h"
+
+typedef struct {
+    int tile_x, tile_y;    // first solid tile on the segment
+    float x, y;            // where the segment enters it, in pixels
+    float distance;        // from the start, in pixels
+} MapRayHit;
+
+/*
+ * Grid traversal over the solid bitset of the map: every tile the segment
+ * touches is visited once, in order, so a query costs one bit test per tile
+ * crossed. Only SHAPE_SOLID blocks, slopes, half tiles and platforms do not.
+ */
+// True if a solid tile lies between (x0, y0) and (x1, y1); hit may be NULL
+bool map_raycast(const Map *map, float x0, float y0, float x1, float y1, MapRayHit *hit);
+
+static inline bool map_line_of_sight(const Map *map, float x0, float y0, float x1, float y1) {
+    return !map_raycast(map, x0, y0, x1, y1, NULL);
+}
+
+// Times queries random segments up to one screen long and logs the queries per second
+void map_raycast_benchmark(const Map *map, int queries);
+
+#endif
@@ -0,0 +1,348 @@
+#include "mapStream.h"
+#include <stdio.h>
+#include <string.h>
+#include "../assets/assetPack.h"
+#include "../memory/memTrack.h"
+
+extern void debug_log(const char *format, ...);
+
+#define MAP_WORLD_HEADER_SIZE 20
+#define MAP_WORLD_TILESET_SIZE 8
+
+static Uint16 map_read_le16(const Uint8 *p) {
+    return (Uint16)(p[0] | p[1] << 8);
+}
+
+static Uint32 map_read_le32(const Uint8 *p) {
+    return (Uint32)p[0] | (Uint32)p[1] << 8 | (Uint32)p[2] << 16 | (Uint32)p[3] << 24;
+}
+
+static int map_stream_plane_count(const MapStream *stream) {
+    return 1 + stream->layer_count;
+}
+
+// Reads the first plane_count planes of a chunk; a missing file is an empty chunk
+static void map_stream_read_chunk(const MapStream *stream, int cx, int cy, Uint16 *planes, int plane_count) {
+    char path[MAP_STREAM_PATH_MAX + 32];
+    size_t count = (size_t)plane_count * MAP_CHUNK_AREA;
+
+    snprintf(path, sizeof(path), "%s/chunk_%d_%d.bin", stream->dir, cx, cy);
+    SDL_RWops *rw = asset_open(path);
+    if (!rw) {
+        memset(planes, 0, count * sizeof(Uint16));
+        return;
+    }
+    size_t got = SDL_RWread(rw, planes, sizeof(Uint16), count);
+    SDL_RWclose(rw);
+    if (got != count) {
+        debug_log("MAP_STREAM: %s zu kurz (%u von %u Tiles)", path, (unsigned)got, (unsigned)count);
+        memset(planes + got, 0, (count - got) * sizeof(Uint16));
+    }
+    for (size_t i = 0; i < got; i++) planes[i] = SDL_SwapLE16(planes[i]);
+}
+
+static int map_stream_loader(void *data) {
+    MapStream *stream = data;
+    for (;;) {
+        SDL_SemWait(stream->queue_sem);
+        if (SDL_AtomicGet(&stream->quit)) break;
+
+        SDL_LockMutex(stream->queue_lock);
+        int slot = stream->queue[stream->queue_head];
+        stream->queue_head = (stream->queue_head + 1) % MAP_CHUNK_SLOTS;
+        stream->queue_count--;
+        SDL_UnlockMutex(stream->queue_lock);
+
+        MapChunk *chunk = &stream->slots[slot];
+        map_stream_read_chunk(stream, chunk->cx, chunk->cy, chunk->planes, map_stream_plane_count(stream));
+        SDL_AtomicSet(&chunk->state, MAP_CHUNK_READY);
+    }
+    return 0;
+}
+
+MapStream *map_stream_open(const char *dir) {
+    char path[MAP_STREAM_PATH_MAX + 16];
+    Uint8 header[MAP_WORLD_HEADER_SIZE];
+
+    snprintf(path, sizeof(path), "%s/world.bin", dir);
+    SDL_RWops *rw = asset_open(path);
+    if (!rw) return NULL;
+
+    if (SDL_RWread(rw, header, 1, sizeof(header)) != sizeof(header) ||
+        memcmp(header, MAP_WORLD_MAGIC, 4) != 0 || map_read_le32(header + 4) != MAP_WORLD_VERSION) {
+        debug_log("MAP_STREAM: %s ist keine Welt-Datei (Version %d erwartet)", path, MAP_WORLD_VERSION);
+        SDL_RWclose(rw);
+        return NULL;
+    }
+    int chunk_tiles = map_read_le16(header + 12);
+    int layer_count = map_read_le16(header + 14);
+    int tileset_count = map_read_le16(header + 16);
+    if (chunk_tiles != MAP_CHUNK_TILES || layer_count > MAP_CHUNK_LAYERS_MAX || tileset_count > MAP_STREAM_TILESETS_MAX) {
+        debug_log("MAP_STREAM: %s passt nicht (Chunk %d, %d Layer, %d Tilesets)", path, chunk_tiles, layer_count, tileset_count);
+        SDL_RWclose(rw);
+        return NULL;
+    }
+
+    MapStream *stream = mem_calloc(MEM_TAG_MAP, 1, sizeof(MapStream));
+    if (!stream) {
+        SDL_RWclose(rw);
+        return NULL;
+    }
+    snprintf(stream->dir, sizeof(stream->dir), "%s", dir);
+    stream->width = map_read_le16(header + 8);
+    stream->height = map_read_le16(header + 10);
+    stream->tile_size = map_read_le16(header + 18);
+    stream->layer_count = layer_count;
+    stream->tileset_count = tileset_count;
+    stream->chunks_x = (stream->width + MAP_CHUNK_TILES - 1) / MAP_CHUNK_TILES;
+    stream->chunks_y = (stream->height + MAP_CHUNK_TILES - 1) / MAP_CHUNK_TILES;
+
+    for (int i = 0; i < tileset_count; i++) {
+        Uint8 entry[MAP_WORLD_TILESET_SIZE];
+        if (SDL_RWread(rw, entry, 1, sizeof(entry)) != sizeof(entry)) {
+            debug_log("MAP_STREAM: %s endet in den Tilesets", path);
+            SDL_RWclose(rw);
+            mem_free(stream);
+            return NULL;
+        }
+        stream->tileset_firstgids[i] = map_read_le32(entry);
+        stream->tileset_collision[i] = entry[4] != 0;
+    }
+    SDL_RWclose(rw);
+
+    int chunk_count = stream->chunks_x * stream->chunks_y;
+    size_t slot_tiles = (size_t)map_stream_plane_count(stream) * MAP_CHUNK_AREA;
+    stream->lookup = mem_alloc(MEM_TAG_MAP, (size_t)chunk_count);
+    stream->block = mem_alloc(MEM_TAG_MAP, MAP_CHUNK_SLOTS * slot_tiles * sizeof(Uint16));
+    if (!stream->lookup || !stream->block) {
+        map_stream_close(stream);
+        return NULL;
+    }
+    memset(stream->lookup, -1, (size_t)chunk_count);
+    for (int i = 0; i < MAP_CHUNK_SLOTS; i++) {
+        stream->slots[i].planes = stream->block + i * slot_tiles;
+        stream->slots[i].cx = -1;
+        stream->slots[i].cy = -1;
+    }
+
+    stream->queue_lock = SDL_CreateMutex();
+    stream->queue_sem = SDL_CreateSemaphore(0);
+    if (stream->queue_lock && stream->queue_sem) {
+        stream->loader = SDL_CreateThread(map_stream_loader, "map_loader", stream);
+    }
+    if (!stream->loader) {
+        debug_log("MAP_STREAM: Kein Loader-Thread (%s), Chunks laden im Hauptthread", SDL_GetError());
+    }
+
+    debug_log("MAP_STREAM: %s %dx%d Tiles, %dx%d Chunks, %d Layer, %u KB fuer %d Slots",
+              dir, stream->width, stream->height, stream->chunks_x, stream->chunks_y, layer_count,
+              (unsigned)(MAP_CHUNK_SLOTS * slot_tiles * sizeof(Uint16) / 1024), MAP_CHUNK_SLOTS);
+    return stream;
+}
+
+void map_stream_close(MapStream *stream) {
+    if (!stream) return;
+    if (stream->loader) {
+        // A chunk in flight is finished first, the rest of the queue is dropped
+        SDL_AtomicSet(&stream->quit, 1);
+        SDL_SemPost(stream->queue_sem);
+        SDL_WaitThread(stream->loader, NULL);
+    }
+    if (stream->queue_sem) SDL_DestroySemaphore(stream->queue_sem);
+    if (stream->queue_lock) SDL_DestroyMutex(stream->queue_lock);
+    mem_free(stream->block);
+    mem_free(stream->lookup);
+    mem_free(stream);
+}
+
+const Uint16 *map_stream_layer(const MapStream *stream, int cx, int cy, int layer) {
+    if (cx < 0 || cy < 0 || cx >= stream->chunks_x || cy >= stream->chunks_y) return NULL;
+    int slot = stream->lookup[cy * stream->chunks_x + cx];
+    if (slot < 0) return NULL;
+    return stream->slots[slot].planes + (size_t)(1 + layer) * MAP_CHUNK_AREA;
+}
+
+// Opacity mask of a chunk, from its render layers; backgrounds behind it are not drawn
+static void map_stream_build_opaque(const MapStream *stream, MapChunk *chunk) {
+    memset(chunk->opaque, 0, sizeof(chunk->opaque));
+    if (!stream->opaque_gids) return;
+    for (int layer = 0; layer < stream->layer_count; layer++) {
+        const Uint16 *plane = chunk->planes + (size_t)(1 + layer) * MAP_CHUNK_AREA;
+        for (int i = 0; i < MAP_CHUNK_AREA; i++) {
+            if (map_gid_opaque(stream->opaque_gids, plane[i])) chunk->opaque[i / MAP_CHUNK_TILES] |= 1u << (i % MAP_CHUNK_TILES);
+        }
+    }
+}
+
+static void map_stream_publish(MapStream *stream, int slot) {
+    MapChunk *chunk = &stream->slots[slot];
+    map_stream_build_opaque(stream, chunk);
+    stream->lookup[chunk->cy * stream->chunks_x + chunk->cx] = (Sint8)slot;
+    SDL_AtomicSet(&chunk->state, MAP_CHUNK_RESIDENT);
+}
+
+// Free slot, or the resident one wanted least recently that is not wanted now
+static int map_stream_claim(MapStream *stream) {
+    int oldest = -1;
+    for (int i = 0; i < MAP_CHUNK_SLOTS; i++) {
+        MapChunk *chunk = &stream->slots[i];
+        int state = SDL_AtomicGet(&chunk->state);
+        if (state == MAP_CHUNK_FREE) return i;
+        if (state != MAP_CHUNK_RESIDENT || chunk->last_wanted == stream->update_count) continue;
+        if (oldest < 0 || chunk->last_wanted < stream->slots[oldest].last_wanted) oldest = i;
+    }
+    if (oldest >= 0) {
+        MapChunk *chunk = &stream->slots[oldest];
+        stream->lookup[chunk->cy * stream->chunks_x + chunk->cx] = -1;
+        SDL_AtomicSet(&chunk->state, MAP_CHUNK_FREE);
+        stream->stats.evictions++;
+    }
+    return oldest;
+}
+
+// Slot holding or loading chunk (cx, cy), -1 if none
+static int map_stream_find(MapStream *stream, int cx, int cy) {
+    int slot = stream->lookup[cy * stream->chunks_x + cx];
+    if (slot >= 0) return slot;
+    for (int i = 0; i < MAP_CHUNK_SLOTS; i++) {
+        MapChunk *chunk = &stream->slots[i];
+        if (chunk->cx == cx && chunk->cy == cy && SDL_AtomicGet(&chunk->state) != MAP_CHUNK_FREE) return i;
+    }
+    return -1;
+}
+
+static bool map_stream_range(const MapStream *stream, const SDL_Rect *region, int *x0, int *y0, int *x1, int *y1) {
+    int chunk_px = MAP_CHUNK_TILES * stream->tile_size;
+    *x0 = SDL_max(region->x, 0) / chunk_px;
+    *y0 = SDL_max(region->y, 0) / chunk_px;
+    *x1 = SDL_min((region->x + region->w - 1) / chunk_px, stream->chunks_x - 1);
+    *y1 = SDL_min((region->y + region->h - 1) / chunk_px, stream->chunks_y - 1);
+    return region->x + region->w > 0 && region->y + region->h > 0 && *x0 <= *x1 && *y0 <= *y1;
+}
+
+// The frame cannot go on without this chunk: finish or do its load right here
+static void map_stream_require(MapStream *stream, int cx, int cy) {
+    int slot = map_stream_find(stream, cx, cy);
+    if (slot >= 0 && SDL_AtomicGet(&stream->slots[slot].state) == MAP_CHUNK_RESIDENT) {
+        stream->slots[slot].last_wanted = stream->update_count;
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (slot >= 0) {
+        while (SDL_AtomicGet(&stream->slots[slot].state) == MAP_CHUNK_LOADING) SDL_Delay(1);
+    } else {
+        slot = map_stream_claim(stream);
+        if (slot < 0) {
+            debug_log("MAP_STREAM: Kein Slot fuer Chunk %d,%d", cx, cy);
+            return;
+        }
+        MapChunk *chunk = &stream->slots[slot];
+        chunk->cx = cx;
+        chunk->cy = cy;
+        map_stream_read_chunk(stream, cx, cy, chunk->planes, map_stream_plane_count(stream));
+    }
+    Uint64 ticks = SDL_GetPerformanceCounter() - start;
+
+    stream->slots[slot].last_wanted = stream->update_count;
+    map_stream_publish(stream, slot);
+    stream->stats.stalls++;
+    stream->stats.stall_ticks += ticks;
+    if (ticks > stream->stats.stall_worst) stream->stats.stall_worst = ticks;
+    debug_log("MAP_STREAM: Stall %.2f ms fuer Chunk %d,%d", ticks * 1000.0 / SDL_GetPerformanceFrequency(), cx, cy);
+}
+
+static void map_stream_request(MapStream *stream, int cx, int cy) {
+    int slot = map_stream_find(stream, cx, cy);
+    if (slot >= 0) {
+        stream->slots[slot].last_wanted = stream->update_count;
+        return;
+    }
+    slot = map_stream_claim(stream);
+    if (slot < 0) return;   // every slot wanted, the lookahead waits
+
+    MapChunk *chunk = &stream->slots[slot];
+    chunk->cx = cx;
+    chunk->cy = cy;
+    chunk->last_wanted = stream->update_count;
+
+    if (!stream->loader) {
+        // No thread available: load it right here
+        map_stream_read_chunk(stream, cx, cy, chunk->planes, map_stream_plane_count(stream));
+        map_stream_publish(stream, slot);
+        stream->stats.loads++;
+        return;
+    }
+
+    SDL_AtomicSet(&chunk->state, MAP_CHUNK_LOADING);
+    SDL_LockMutex(stream->queue_lock);
+    stream->queue[(stream->queue_head + stream->queue_count) % MAP_CHUNK_SLOTS] = slot;
+    stream->queue_count++;
+    SDL_UnlockMutex(stream->queue_lock);
+    SDL_SemPost(stream->queue_sem);
+}
+
+// Keeps what is already there away from map_stream_claim during this update
+static void map_stream_mark(MapStream *stream, const SDL_Rect *region) {
+    int x0, y0, x1, y1;
+    if (!map_stream_range(stream, region, &x0, &y0, &x1, &y1)) return;
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int slot = map_stream_find(stream, cx, cy);
+            if (slot >= 0) stream->slots[slot].last_wanted = stream->update_count;
+        }
+    }
+}
+
+void map_stream_update(MapStream *stream, const SDL_Rect *required, const SDL_Rect *wanted) {
+    int x0, y0, x1, y1;
+    stream->update_count++;
+
+    for (int i = 0; i < MAP_CHUNK_SLOTS; i++) {
+        if (SDL_AtomicGet(&stream->slots[i].state) != MAP_CHUNK_READY) continue;
+        map_stream_publish(stream, i);
+        stream->stats.loads++;
+    }
+    map_stream_mark(stream, required);
+    map_stream_mark(stream, wanted);
+
+    // Required first, so the lookahead never takes the slots they need
+    if (map_stream_range(stream, required, &x0, &y0, &x1, &y1)) {
+        for (int cy = y0; cy <= y1; cy++)
+            for (int cx = x0; cx <= x1; cx++) map_stream_require(stream, cx, cy);
+    }
+    if (map_stream_range(stream, wanted, &x0, &y0, &x1, &y1)) {
+        for (int cy = y0; cy <= y1; cy++)
+            for (int cx = x0; cx <= x1; cx++) map_stream_request(stream, cx, cy);
+    }
+}
+
+void map_stream_scan(MapStream *stream, MapStreamVisitor visit, void *ctx) {
+    Uint16 *plane = mem_alloc(MEM_TAG_MAP, MAP_CHUNK_AREA * sizeof(Uint16));
+    if (!plane) return;
+
+    for (int cy = 0; cy < stream->chunks_y; cy++) {
+        for (int cx = 0; cx < stream->chunks_x; cx++) {
+            map_stream_read_chunk(stream, cx, cy, plane, 1);
+            for (int i = 0; i < MAP_CHUNK_AREA; i++) {
+                if (plane[i] == 0) continue;
+                int tx = cx * MAP_CHUNK_TILES + i % MAP_CHUNK_TILES;
+                int ty = cy * MAP_CHUNK_TILES + i / MAP_CHUNK_TILES;
+                if (tx < stream->width && ty < stream->height) visit(ctx, plane[i], tx, ty);
+            }
+        }
+    }
+    mem_free(plane);
+}
+
+void map_stream_report(MapStream *stream, const char *label) {
+    int resident = 0;
+    for (int i = 0; i < MAP_CHUNK_SLOTS; i++) {
+        if (SDL_AtomicGet(&stream->slots[i].state) == MAP_CHUNK_RESIDENT) resident++;
+    }
+    double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+    debug_log("MAP_STREAM: === %s === %d/%d Slots belegt, %d Loads, %d Evictions", label,
+              resident, MAP_CHUNK_SLOTS, stream->stats.loads, stream->stats.evictions);
+    debug_log("MAP_STREAM: %d Stalls, gesamt %.2f ms, laengster %.2f ms", stream->stats.stalls,
+              stream->stats.stall_ticks * ms_per_tick, stream->stats.stall_worst * ms_per_tick);
+}
@@ -0,0 +1,115 @@
+#ifndef MAP_STREAM_H
+#define MAP_STREAM_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+// Written by tools/split_map.py into <map>.chunks/ next to the JSON
+#define MAP_WORLD_MAGIC "RWLD"
+#define MAP_WORLD_VERSION 1
+#define MAP_CHUNK_TILES 32
+#define MAP_CHUNK_AREA (MAP_CHUNK_TILES * MAP_CHUNK_TILES)
+#define MAP_CHUNK_LAYERS_MAX 8
+#define MAP_STREAM_TILESETS_MAX 8
+// Resident set: the required region (view + enemy edge margin) spans up to
+// 4x3 chunks, the lookahead one more column and row
+#define MAP_CHUNK_SLOTS 20
+#define MAP_STREAM_PATH_MAX 128
+
+typedef enum {
+    MAP_CHUNK_FREE,
+    MAP_CHUNK_LOADING,     // owned by the loader thread
+    MAP_CHUNK_READY,       // loaded, published by the next map_stream_update
+    MAP_CHUNK_RESIDENT
+} MapChunkState;
+
+typedef struct {
+    int cx, cy;
+    Uint16 *planes;        // collision plane, then the render layers, MAP_CHUNK_AREA each
+    Uint32 last_wanted;    // update count the chunk was last inside the wanted region
+    SDL_atomic_t state;    // MapChunkState
+    Uint32 opaque[MAP_CHUNK_TILES]; // per row, bit per tile covered by an opaque render tile
+} MapChunk;
+
+typedef struct {
+    int loads;             // finished on the loader thread
+    int stalls;            // required chunks loaded while the frame waited
+    int evictions;
+    Uint64 stall_ticks;
+    Uint64 stall_worst;
+} MapStreamStats;
+
+/*
+ * Chunked map: only the chunks around the camera are in memory, in a fixed
+ * set of slots. map_stream_update runs on the main thread between frames
+ * (update thread idle): it publishes loaded chunks, queues the ones the
+ * camera heads for on the loader thread, evicts the least recently wanted
+ * ones and loads required chunks that are still missing on the spot.
+ *
+ * The lookup table and the published slots only change there, so the
+ * update thread and the renderer read them without locks.
+ */
+typedef struct MapStream {
+    char dir[MAP_STREAM_PATH_MAX];
+    int width, height;     // in tiles
+    int tile_size;
+    int chunks_x, chunks_y;
+    int layer_count;
+    int tileset_count;
+    Uint32 tileset_firstgids[MAP_STREAM_TILESETS_MAX];
+    bool tileset_collision[MAP_STREAM_TILESETS_MAX];
+    const Uint8 *opaque_gids; // owned by the Map (map.h), NULL = nothing is opaque
+
+    MapChunk slots[MAP_CHUNK_SLOTS];
+    Uint16 *block;         // plane storage of all slots
+    Sint8 *lookup;         // [chunks_y * chunks_x] slot or -1
+    Uint32 update_count;
+
+    // Loader thread, fed through a small ring of slot indices
+    SDL_Thread *loader;
+    SDL_mutex *queue_lock;
+    SDL_sem *queue_sem;
+    int queue[MAP_CHUNK_SLOTS];
+    int queue_head, queue_count;
+    SDL_atomic_t quit;
+
+    MapStreamStats stats;
+} MapStream;
+
+// Bit per gid, set when every pixel of the tile is opaque
+#define MAP_OPAQUE_GIDS 65536
+static inline int map_gid_opaque(const Uint8 *bits, int gid) {
+    return bits && gid > 0 && gid < MAP_OPAQUE_GIDS && (bits[gid >> 3] >> (gid & 7) & 1);
+}
+
+// Opens <dir>/world.bin; NULL if the map was not split (or on error)
+MapStream *map_stream_open(const char *dir);
+void map_stream_close(MapStream *stream);
+
+// Collision gid at tile (tx, ty) inside the map, 0 in a chunk that is not resident
+static inline int map_stream_collision(const MapStream *stream, int tx, int ty) {
+    int slot = stream->lookup[(ty / MAP_CHUNK_TILES) * stream->chunks_x + tx / MAP_CHUNK_TILES];
+    if (slot < 0) return 0;
+    return stream->slots[slot].planes[(ty % MAP_CHUNK_TILES) * MAP_CHUNK_TILES + tx % MAP_CHUNK_TILES];
+}
+
+// Tile (tx, ty) inside the map is covered by an opaque render tile, 0 in a chunk that is not resident
+static inline int map_stream_opaque(const MapStream *stream, int tx, int ty) {
+    int slot = stream->lookup[(ty / MAP_CHUNK_TILES) * stream->chunks_x + tx / MAP_CHUNK_TILES];
+    if (slot < 0) return 0;
+    return (int)(stream->slots[slot].opaque[ty % MAP_CHUNK_TILES] >> (tx % MAP_CHUNK_TILES) & 1u);
+}
+
+// Render layer plane of the chunk at (cx, cy), NULL if not resident
+const Uint16 *map_stream_layer(const MapStream *stream, int cx, int cy, int layer);
+
+// Regions in pixels: required chunks are loaded before this returns, wanted ones in the background
+void map_stream_update(MapStream *stream, const SDL_Rect *required, const SDL_Rect *wanted);
+
+// Visits every non-empty collision tile of the whole map, one chunk file at a time (level load)
+typedef void (*MapStreamVisitor)(void *ctx, int gid, int tx, int ty);
+void map_stream_scan(MapStream *stream, MapStreamVisitor visit, void *ctx);
+
+void map_stream_report(MapStream *stream, const char *label);
+
+#endif
@@ -0,0 +1,102 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+extern void debug_log(const char *format, ...);
+
+#define ARENA_ALIGN 8
+#define ARENA_ALIGN_UP(n) (((n) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+#define ARENA_HEADER ARENA_ALIGN_UP(sizeof(ArenaBlock))
+
+void arena_init(Arena *arena, const char *name, size_t block_size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->name = name;
+    arena->block_size = block_size;
+}
+
+static ArenaBlock *arena_new_block(Arena *arena, size_t min_size) {
+    size_t size = arena->block_size > min_size ? arena->block_size : min_size;
+    ArenaBlock *block = mem_alloc(MEM_TAG_ARENA, ARENA_HEADER + size);
+    if (!block) {
+        debug_log("ARENA_ERROR: %s - kein Speicher fuer Block (%u Bytes)", arena->name, (unsigned)(ARENA_HEADER + size));
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    arena->reserved += ARENA_HEADER + size;
+    return block;
+}
+
+void *arena_alloc(Arena *arena, MemTag tag, size_t size) {
+    size = ARENA_ALIGN_UP(size ? size : 1);
+
+    ArenaBlock *block = arena->current;
+    // Walk the retained blocks before asking the heap for a new one
+    while (block && block->size - block->used < size) {
+        if (!block->next) break;
+        block = block->next;
+    }
+
+    if (!block || block->size - block->used < size) {
+        ArenaBlock *fresh = arena_new_block(arena, size);
+        if (!fresh) return NULL;
+        if (block) block->next = fresh;
+        else arena->first = fresh;
+        block = fresh;
+    }
+
+    arena->current = block;
+    void *ptr = (char *)block + ARENA_HEADER + block->used;
+    block->used += size;
+    arena->used += size;
+    arena->allocations++;
+    arena->tag_used[tag] += size;
+    mem_track_move(MEM_TAG_ARENA, tag, size);
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return ptr;
+}
+
+void *arena_calloc(Arena *arena, MemTag tag, size_t count, size_t size) {
+    void *ptr = arena_alloc(arena, tag, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+// Handed-out bytes go back to the arena's own bucket in the memory report
+static void arena_release_tags(Arena *arena) {
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        if (arena->tag_used[t]) mem_track_move((MemTag)t, MEM_TAG_ARENA, arena->tag_used[t]);
+        arena->tag_used[t] = 0;
+    }
+}
+
+void arena_reset(Arena *arena) {
+    if (arena->allocations > 0) {
+        debug_log("ARENA: %s reset - %u Bytes in %d Allocs, Peak %u, Reserviert %u",
+                  arena->name, (unsigned)arena->used, arena->allocations,
+                  (unsigned)arena->peak, (unsigned)arena->reserved);
+    }
+    for (ArenaBlock *block = arena->first; block; block = block->next) {
+        block->used = 0;
+    }
+    arena_release_tags(arena);
+    arena->current = arena->first;
+    arena->used = 0;
+    arena->allocations = 0;
+}
+
+void arena_destroy(Arena *arena) {
+    arena_release_tags(arena);
+    ArenaBlock *block = arena->first;
+    while (block) {
+        ArenaBlock *next = block->next;
+        mem_free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+    arena->reserved = 0;
+    arena->allocations = 0;
+}
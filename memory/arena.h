@@ -0,0 +1,39 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "memTrack.h"
+
+/*
+ * Bump allocator for everything that lives exactly as long as a level.
+ * Individual frees are no-ops; arena_reset() releases all allocations at once
+ * but keeps the blocks, so repeated level switches reuse the same memory
+ * instead of fragmenting the heap.
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;  // usable bytes after the header
+    size_t used;
+} ArenaBlock;
+
+typedef struct Arena {
+    const char *name;
+    ArenaBlock *first;
+    ArenaBlock *current;
+    size_t block_size;
+    size_t used;        // bytes handed out since the last reset
+    size_t peak;        // highest 'used' ever seen
+    size_t reserved;    // bytes held in blocks (including headers)
+    int allocations;
+    size_t tag_used[MEM_TAG_COUNT]; // 'used' split by the subsystem that asked for it
+} Arena;
+
+void arena_init(Arena *arena, const char *name, size_t block_size);
+// tag: subsystem the bytes are reported under by mem_track_report
+void *arena_alloc(Arena *arena, MemTag tag, size_t size);
+void *arena_calloc(Arena *arena, MemTag tag, size_t count, size_t size);
+void arena_reset(Arena *arena);
+void arena_destroy(Arena *arena);
+
+#endif
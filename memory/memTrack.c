@@ -0,0 +1,154 @@
+#include "memTrack.h"
+#include <stdlib.h>
+#include <string.h>
+
+extern void debug_log(const char *format, ...);
+
+// Keeps the block behind the header as aligned as malloc's own result
+#define MEM_HEADER_SIZE 16
+
+typedef union {
+    struct {
+        Uint32 tag;
+        Uint32 size;
+    } info;
+    Uint8 pad[MEM_HEADER_SIZE];
+} MemHeader;
+
+typedef struct {
+    size_t current;
+    size_t peak;
+    int live;          // allocations not freed yet
+    int total;         // allocations since start
+} MemStats;
+
+static const char *mem_tag_names[MEM_TAG_COUNT] = {
+    "map", "cute_tiled", "sprites", "enemies", "audio", "ui", "assets", "arena"
+};
+
+static MemStats g_mem[MEM_TAG_COUNT];
+static MemStats g_tex;
+static size_t g_mem_peak_total = 0;
+// Asset streams are opened from the music loader thread as well
+static SDL_SpinLock g_mem_lock = 0;
+
+static void mem_stats_add(MemStats *s, size_t bytes, int allocs) {
+    s->current += bytes;
+    s->live += allocs;
+    s->total += allocs;
+    if (s->current > s->peak) s->peak = s->current;
+}
+
+static void mem_stats_sub(MemStats *s, size_t bytes, int allocs) {
+    s->current = bytes < s->current ? s->current - bytes : 0;
+    s->live -= allocs;
+}
+
+static void mem_update_total_peak(void) {
+    size_t total = 0;
+    for (int i = 0; i < MEM_TAG_COUNT; i++) total += g_mem[i].current;
+    if (total > g_mem_peak_total) g_mem_peak_total = total;
+}
+
+void *mem_alloc(MemTag tag, size_t size) {
+    MemHeader *h = malloc(MEM_HEADER_SIZE + size);
+    if (!h) {
+        debug_log("MEM_ERROR: %s - kein Speicher fuer %u Bytes", mem_tag_names[tag], (unsigned)size);
+        return NULL;
+    }
+    h->info.tag = (Uint32)tag;
+    h->info.size = (Uint32)size;
+
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_add(&g_mem[tag], size, 1);
+    mem_update_total_peak();
+    SDL_AtomicUnlock(&g_mem_lock);
+    return (Uint8 *)h + MEM_HEADER_SIZE;
+}
+
+void *mem_calloc(MemTag tag, size_t count, size_t size) {
+    void *ptr = mem_alloc(tag, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void mem_free(void *ptr) {
+    if (!ptr) return;
+    MemHeader *h = (MemHeader *)((Uint8 *)ptr - MEM_HEADER_SIZE);
+
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_sub(&g_mem[h->info.tag], h->info.size, 1);
+    SDL_AtomicUnlock(&g_mem_lock);
+    free(h);
+}
+
+void mem_track_add(MemTag tag, size_t bytes) {
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_add(&g_mem[tag], bytes, 1);
+    mem_update_total_peak();
+    SDL_AtomicUnlock(&g_mem_lock);
+}
+
+void mem_track_sub(MemTag tag, size_t bytes) {
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_sub(&g_mem[tag], bytes, 1);
+    SDL_AtomicUnlock(&g_mem_lock);
+}
+
+void mem_track_move(MemTag from, MemTag to, size_t bytes) {
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_sub(&g_mem[from], bytes, 0);
+    mem_stats_add(&g_mem[to], bytes, 0);
+    SDL_AtomicUnlock(&g_mem_lock);
+}
+
+static int mem_next_pow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+size_t mem_track_texture_bytes(SDL_Texture *texture) {
+    Uint32 format = 0;
+    int w = 0, h = 0;
+    if (!texture || SDL_QueryTexture(texture, &format, NULL, &w, &h) != 0) return 0;
+    return (size_t)mem_next_pow2(w) * (size_t)mem_next_pow2(h) * SDL_BYTESPERPIXEL(format);
+}
+
+void mem_track_texture_created(SDL_Texture *texture) {
+    size_t bytes = mem_track_texture_bytes(texture);
+    if (bytes == 0) return;
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_add(&g_tex, bytes, 1);
+    SDL_AtomicUnlock(&g_mem_lock);
+}
+
+void mem_track_texture_destroy(SDL_Texture *texture) {
+    if (!texture) return;
+    size_t bytes = mem_track_texture_bytes(texture);
+    SDL_AtomicLock(&g_mem_lock);
+    mem_stats_sub(&g_tex, bytes, 1);
+    SDL_AtomicUnlock(&g_mem_lock);
+    SDL_DestroyTexture(texture);
+}
+
+void mem_track_report(const char *label) {
+    SDL_AtomicLock(&g_mem_lock);
+    MemStats mem[MEM_TAG_COUNT];
+    MemStats tex = g_tex;
+    size_t peak_total = g_mem_peak_total;
+    memcpy(mem, g_mem, sizeof(mem));
+    SDL_AtomicUnlock(&g_mem_lock);
+
+    size_t total = 0;
+    debug_log("MEM: === %s ===", label);
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        total += mem[i].current;
+        debug_log("MEM: %-10s %6u KB (Peak %6u KB) %5d live / %6d allocs",
+                  mem_tag_names[i], (unsigned)(mem[i].current / 1024), (unsigned)(mem[i].peak / 1024),
+                  mem[i].live, mem[i].total);
+    }
+    debug_log("MEM: heap       %6u KB (Peak %6u KB)", (unsigned)(total / 1024), (unsigned)(peak_total / 1024));
+    debug_log("MEM: textures   %6u KB (Peak %6u KB) %5d live / %6d created",
+              (unsigned)(tex.current / 1024), (unsigned)(tex.peak / 1024), tex.live, tex.total);
+}
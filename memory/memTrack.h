@@ -0,0 +1,49 @@
+#ifndef MEM_TRACK_H
+#define MEM_TRACK_H
+
+#include <SDL.h>
+#include <stddef.h>
+
+/*
+ * Heap bookkeeping per subsystem. mem_alloc/mem_free wrap malloc/free with a
+ * small header (tag + size), arena carve-outs are moved from MEM_TAG_ARENA to
+ * the tag of the caller, so every byte is counted exactly once: MEM_TAG_ARENA
+ * is what the arenas hold but have not handed out.
+ *
+ * SDL, SDL_image and SDL_mixer allocate on their own; their big consumers are
+ * covered by estimates instead: textures from size and format (separate
+ * counter), sound effects from the decoded chunk length.
+ */
+typedef enum {
+    MEM_TAG_MAP,       // map JSON text
+    MEM_TAG_TILED,     // cute_tiled DOM
+    MEM_TAG_SPRITES,   // frame arrays
+    MEM_TAG_ENEMIES,   // enemy store, spatial grid, projectile pool, restart snapshot
+    MEM_TAG_AUDIO,     // decoded sound effects
+    MEM_TAG_UI,        // render snapshots, HUD
+    MEM_TAG_ASSETS,    // pack table of contents, inflated entries, manifests
+    MEM_TAG_ARENA,     // arena blocks not handed out yet
+    MEM_TAG_COUNT
+} MemTag;
+
+void *mem_alloc(MemTag tag, size_t size);
+void *mem_calloc(MemTag tag, size_t count, size_t size);
+// Only for pointers from mem_alloc / mem_calloc, NULL is ignored
+void mem_free(void *ptr);
+
+// Memory owned by someone else (arenas, SDL_mixer), reported under tag
+void mem_track_add(MemTag tag, size_t bytes);
+void mem_track_sub(MemTag tag, size_t bytes);
+void mem_track_move(MemTag from, MemTag to, size_t bytes);
+
+// Estimated from size and format, padded to powers of two like the PSP renderer stores them
+void mem_track_texture_created(SDL_Texture *texture);
+// Use instead of SDL_DestroyTexture for every texture announced above
+void mem_track_texture_destroy(SDL_Texture *texture);
+// The estimate itself, 0 for NULL
+size_t mem_track_texture_bytes(SDL_Texture *texture);
+
+// Current / peak / live allocations per tag plus textures, into the debug log
+void mem_track_report(const char *label);
+
+#endif
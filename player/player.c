@@ -4,12 +4,15 @@
 #include <stdlib.h>
 #include <math.h> // Added for fabs()
 #include "../map/map.h"
+#include "../ui/ui.h"
+#include "../render/renderSnapshot.h"
 
 #define PLAYER_ATTACK_BASE_PATH "resources/sprites/player/attack/frame"
 #define PLAYER_IDLE_BASE_PATH   "resources/sprites/player/idle/hero-idle-"
 #define PLAYER_RUN_BASE_PATH    "resources/sprites/player/run/hero-run-"
 #define PLAYER_HURT_BASE_PATH   "resources/sprites/player/hero-hurt.png"
 #define PLAYER_JUMP_BASE_PATH   "resources/sprites/player/jump/hero-jump-"
+#define PLAYER_ATTACK_SFX_PATH  "resources/sfx/blade_draw-99885.wav"
 
 extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
 extern void debug_log(const char *format, ...);
@@ -27,7 +30,7 @@ extern void debug_log(const char *format, ...);
 #define GRAVITY 0.4f
 #define JUMP_FORCE 9.0f
 #define MAX_FALL_SPEED 10.0f
-#define ANIMATION_SPEED 85
+#define ANIMATION_SPEED 85 // ms
 
 // -------------------------------------------------------------
 // Cleanup
@@ -35,10 +38,7 @@ extern void debug_log(const char *format, ...);
 void player_cleanup(Player *player) {
     entity_cleanup(&player->entity);
     for (int i = 0; i < player->inventory_count; i++) {
-        if (player->inventory[i].texture) {
-            SDL_DestroyTexture(player->inventory[i].texture);
-            player->inventory[i].texture = NULL;
-        }
+        item_cleanup(&player->inventory[i]);
     }
 }
 
@@ -52,11 +52,15 @@ Player player_init(SDL_Renderer *renderer) {
     if (!entity_load_frames(renderer, &e->idle, PLAYER_IDLE_BASE_PATH)) goto fail;
     if (!entity_load_frames(renderer, &e->run, PLAYER_RUN_BASE_PATH)) goto fail;
     if (!entity_load_frames(renderer, &e->attack, PLAYER_ATTACK_BASE_PATH)) goto fail;
-    if (!entity_load_frame(renderer, &e->hurt, PLAYER_HURT_BASE_PATH)) goto fail;
+    // Only shown after a hit, loaded on the first one
+    if (!entity_register_frame(renderer, &e->hurt, PLAYER_HURT_BASE_PATH)) goto fail;
     if (!entity_load_frames(renderer, &e->jump, PLAYER_JUMP_BASE_PATH)) goto fail;
 
     SDL_QueryTexture(e->idle.frames[0], NULL, NULL, &e->sprite_w, &e->sprite_h);
 
+    // Shared through the sfx bank, NULL if audio is unavailable
+    e->attack_sfx = sfx_load(PLAYER_ATTACK_SFX_PATH);
+
     // Hitbox
     e->rect.w = (int)(e->sprite_w * HIT_BOX_SCALE_W);
     e->rect.h = (int)(e->sprite_h * HIT_BOX_SCALE_H);
@@ -71,16 +75,16 @@ Player player_init(SDL_Renderer *renderer) {
     player.attack_timer_end = 0;
     player.attack_cooldown_end = 0;
     player.hurt_timer_end = 0;
-    player.prev_buttons = 0;
-    e->last_time = SDL_GetTicks() - ANIMATION_SPEED;
+    player.coyote_end = 0;
 
     e->health = PLAYER_MAX_HEALTH;
+    ui_mark_hud_dirty();
     e->movement_speed = PLAYER_MOVEMENT_SPEED;
     e->vel_x = 0;
     e->vel_y = 0;
     e->on_ground = 0;
     e->flip_direction = SDL_FLIP_NONE;
-    e->last_time = SDL_GetTicks();
+    e->last_time = 0;
 
     return player;
 
@@ -93,11 +97,11 @@ Player player_init(SDL_Renderer *renderer) {
 // -------------------------------------------------------------
 // Input Handling (FIXED)
 // -------------------------------------------------------------
-void player_handle_input(Player *player, const SceCtrlData *pad) {
+void player_handle_input(Player *player, InputState *in, Uint32 now) {
     Entity *e = &player->entity;
 
     // 1. Attack Freeze
-    if ((int)SDL_GetTicks() < (int)player->attack_timer_end) {
+    if (now < player->attack_timer_end) {
         // Apply friction even while attacking so you slide to a stop
         e->vel_x *= FRICTION;
         if (fabs(e->vel_x) < 0.1f) e->vel_x = 0;
@@ -105,28 +109,26 @@ void player_handle_input(Player *player, const SceCtrlData *pad) {
     }
 
     // 2. Start Attack
-    if ((pad->Buttons & PSP_CTRL_CIRCLE) && SDL_GetTicks() >= player->attack_cooldown_end) {
-        player->attack_timer_end = SDL_GetTicks() + ATTACK_DURATION;
-        player->attack_cooldown_end = SDL_GetTicks() + ATTACK_COOLDOWN;
+    if (input_held(in, PSP_CTRL_CIRCLE) && now >= player->attack_cooldown_end) {
+        player->attack_timer_end = now + FRAME_TICKS(ATTACK_DURATION);
+        player->attack_cooldown_end = now + FRAME_TICKS(ATTACK_COOLDOWN);
         player->current_attack_frame = 0;
         // Don't kill velocity instantly, let friction handle it in the next frame
         return;
     }
 
-    int triangle_just_pressed = (pad->Buttons & PSP_CTRL_TRIANGLE) && !(player->prev_buttons & PSP_CTRL_TRIANGLE);
-    
-    if (triangle_just_pressed && player->inventory_count > 0) {
+    if (input_pressed(in, PSP_CTRL_TRIANGLE) && player->inventory_count > 0) {
         player_consume_item(player, 0);
     }
 
     // 3. Movement (Acceleration / Friction)
     // FIX: Removed "e->vel_x = 0;" here. We MUST preserve velocity between frames.
 
-    if (pad->Buttons & PSP_CTRL_LEFT) {
+    if (input_held(in, PSP_CTRL_LEFT)) {
         e->vel_x -= ACCEL;
         e->flip_direction = SDL_FLIP_HORIZONTAL;
     }
-    else if (pad->Buttons & PSP_CTRL_RIGHT) {
+    else if (input_held(in, PSP_CTRL_RIGHT)) {
         e->vel_x += ACCEL;
         e->flip_direction = SDL_FLIP_NONE;
     }
@@ -142,32 +144,32 @@ void player_handle_input(Player *player, const SceCtrlData *pad) {
     if (e->vel_x > PLAYER_MOVEMENT_SPEED) e->vel_x = PLAYER_MOVEMENT_SPEED;
     if (e->vel_x < -PLAYER_MOVEMENT_SPEED) e->vel_x = -PLAYER_MOVEMENT_SPEED;
 
-    // 4. Jump
-    int cross_just_pressed = (pad->Buttons & PSP_CTRL_CROSS) && !(player->prev_buttons & PSP_CTRL_CROSS);
+    // 4. Jump: buffered presses and coyote time, on_ground is still from the last physics step
+    if (e->on_ground) player->coyote_end = now + FRAME_TICKS(PLAYER_COYOTE_MS);
 
-    if (cross_just_pressed && e->on_ground) {
+    if (input_buffered(in, PSP_CTRL_CROSS, FRAME_TICKS(PLAYER_JUMP_BUFFER_MS)) && now < player->coyote_end) {
+        input_consume(in, PSP_CTRL_CROSS);
         e->vel_y = -JUMP_FORCE;
         e->on_ground = 0;
+        player->coyote_end = now;
     }
-    player->prev_buttons = pad->Buttons;
 
     // Debug Damage
-    if (pad->Buttons & PSP_CTRL_LTRIGGER) {
-        player_decrease_health(player, 1);
+    if (input_held(in, PSP_CTRL_LTRIGGER)) {
+        player_decrease_health(player, 1, now);
     }
 }
 
-void player_update_attack(Player *player) {
-    Uint32 t = SDL_GetTicks();
-    if (t >= player->attack_timer_end) {
+void player_update_attack(Player *player, Uint32 now) {
+    if (now >= player->attack_timer_end) {
         player->attack_rect = (SDL_Rect){0,0,0,0};
         player->attack_sfx_played = false;
         return;
     }
 
-    Uint32 time_since_attack = t - (player->attack_timer_end - ATTACK_DURATION);
-    int frame_duration = ATTACK_DURATION / player->entity.attack.count;
-    player->current_attack_frame = time_since_attack / frame_duration;
+    Uint32 duration = FRAME_TICKS(ATTACK_DURATION);
+    Uint32 ticks_since_attack = now - (player->attack_timer_end - duration);
+    player->current_attack_frame = (int)(ticks_since_attack * player->entity.attack.count / duration);
     if (player->current_attack_frame >= player->entity.attack.count)
         player->current_attack_frame = player->entity.attack.count - 1;
 
@@ -192,15 +194,16 @@ void player_update_attack(Player *player) {
     }
 }
 
-void player_decrease_health(Player *player, int amount) {
-    if (SDL_GetTicks() < player->hurt_timer_end) return;
+void player_decrease_health(Player *player, int amount, Uint32 now) {
+    if (now < player->hurt_timer_end) return;
     player->entity.health -= amount;
-    player->hurt_timer_end = SDL_GetTicks() + HURT_DURATION;
+    player->hurt_timer_end = now + FRAME_TICKS(HURT_DURATION);
     if (player->entity.health < 0) player->entity.health = 0;
+    ui_mark_hud_dirty();
 }
 
-void player_update_animation(Player *player, int is_moving) {
-    entity_update_animation(&player->entity, is_moving, ANIMATION_SPEED);
+void player_update_animation(Player *player, int is_moving, Uint32 now) {
+    entity_update_animation(&player->entity, is_moving, FRAME_TICKS(ANIMATION_SPEED), now);
 }
 
 void player_update_physics(Player *p, struct Map *map){
@@ -226,31 +229,36 @@ void player_consume_item(Player *player, int index) {
         }
         player->inventory_count--;
     }
+    ui_mark_hud_dirty();
 }
 
-void player_render(SDL_Renderer *renderer, Player *player, int is_moving, int camera_x, int camera_y) {
-    Entity *e = &player->entity;
-    SDL_Texture *current_texture = NULL;
-    Uint32 t = SDL_GetTicks();
+void player_render(RenderSnapshot *out, const Player *player, int is_moving, int camera_x, int camera_y, Uint32 now) {
+    const Entity *e = &player->entity;
+    const SpriteFrameArray *clip = NULL;
+    int frame = 0;
 
     if (!e->on_ground && e->jump.count > 0) {
-        current_texture = e->jump.frames[e->current_jump_frame];
+        clip = &e->jump;
+        frame = e->current_jump_frame;
     }
-    else if (SDL_GetTicks() < player->attack_timer_end && e->attack.count > 0) {
-        current_texture = e->attack.frames[player->current_attack_frame];
+    else if (now < player->attack_timer_end && e->attack.count > 0) {
+        clip = &e->attack;
+        frame = player->current_attack_frame;
     }
-    else if (SDL_GetTicks() < player->hurt_timer_end && e->hurt.count > 0) {
-        current_texture = e->hurt.frames[0];
+    else if (now < player->hurt_timer_end && e->hurt.count > 0) {
+        clip = &e->hurt;
     }
     else {
         if (is_moving && e->run.count > 0) {
-            current_texture = e->run.frames[e->current_run_frame];
+            clip = &e->run;
+            frame = e->current_run_frame;
         } else if (!is_moving && e->idle.count > 0) {
-            current_texture = e->idle.frames[e->current_idle_frame];
+            clip = &e->idle;
+            frame = e->current_idle_frame;
         }
     }
 
-    if (!current_texture) return;
+    if (!clip) return;
 
     SDL_Rect render_rect = {
             e->rect.x - e->offset_x - camera_x,
@@ -259,22 +267,18 @@ void player_render(SDL_Renderer *renderer, Player *player, int is_moving, int ca
             e->sprite_h
     };
 
+    RenderItem *sprite = render_snapshot_frame(out, clip, frame, &render_rect, e->flip_direction);
+
     // --- Hurt Blinking ---
-    SDL_SetTextureColorMod(current_texture, 255, 255, 255);
-    if (t < player->hurt_timer_end && t % 100 < 50) {
-        SDL_SetTextureColorMod(current_texture, 255, 100, 100);
+    if (sprite && now < player->hurt_timer_end && now % FRAME_TICKS(100) < FRAME_TICKS(50)) {
+        sprite->color.g = 100;
+        sprite->color.b = 100;
     }
 
-    SDL_RenderCopyEx(renderer, current_texture, NULL, &render_rect, 0.0, NULL, e->flip_direction);
-
 #ifdef DEBUG_DRAW_HITBOX
-    Uint8 old_r, old_g, old_b, old_a;
-    SDL_GetRenderDrawColor(renderer, &old_r, &old_g, &old_b, &old_a);
     SDL_Rect debug_rect = e->rect;
     debug_rect.x -= camera_x;
     debug_rect.y -= camera_y;
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &debug_rect);
-    SDL_SetRenderDrawColor(renderer, old_r, old_g, old_b, old_a);
+    render_snapshot_rect(out, &debug_rect, 255, 0, 0, false);
 #endif
 }
\ No newline at end of file
@@ -2,9 +2,10 @@
 #define PLAYER_H
 
 #include <SDL.h>
-#include <pspctrl.h>
 #include "../entity/entity.h"
 #include "../items/item.h"
+#include "../clock/frameClock.h"
+#include "../input/input.h"
 
 #define PLAYER_MAX_HEALTH 100
 #define PLAYER_MOVEMENT_SPEED 3.0f
@@ -16,16 +17,19 @@
 #define ATTACK_HITBOX_OFFSET_Y 5
 #define ATTACK_OVERLAP 15
 #define MAX_INVENTORY 5
+#define PLAYER_JUMP_BUFFER_MS 100 // a jump pressed this long before landing still fires
+#define PLAYER_COYOTE_MS 100      // and this long after running off a ledge
 
 struct Map;
 
+// Timers are FrameClock ticks
 typedef struct Player {
     Entity entity;
     Uint32 attack_timer_end;
     Uint32 attack_cooldown_end;
     Uint32 hurt_timer_end;
     int current_attack_frame;
-    Uint32 prev_buttons;
+    Uint32 coyote_end;     // jumping from the air is allowed until this tick
     SDL_Rect attack_rect;
     bool attack_sfx_played;
     Item inventory[MAX_INVENTORY];
@@ -34,12 +38,13 @@ typedef struct Player {
 } Player;
 
 Player player_init(SDL_Renderer *renderer);
-void player_handle_input(Player *player, const SceCtrlData *pad);
-void player_update_attack(Player *player);
+// now: FrameClock tick of the current frame
+void player_handle_input(Player *player, InputState *in, Uint32 now);
+void player_update_attack(Player *player, Uint32 now);
 void player_update_physics(Player *p, struct Map *map);
-void player_decrease_health(Player *player, int amount);
-void player_update_animation(Player *player, int is_moving);
-void player_render(SDL_Renderer *renderer, Player *player, int is_moving, int camera_x, int camera_y);
+void player_decrease_health(Player *player, int amount, Uint32 now);
+void player_update_animation(Player *player, int is_moving, Uint32 now);
+void player_render(struct RenderSnapshot *out, const Player *player, int is_moving, int camera_x, int camera_y, Uint32 now);
 void player_cleanup(Player *player);
 
 void player_consume_item(Player *player, int inventory_index);
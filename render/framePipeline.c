@@ -0,0 +1,96 @@
+#include "framePipeline.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../debug/perf.h"
+#include "../memory/memTrack.h"
+
+extern void debug_log(const char *format, ...);
+
+static RenderSnapshot *frame_pipeline_back(FramePipeline *pipe) {
+    return &pipe->snapshots[pipe->front ^ 1];
+}
+
+#ifdef FRAME_PIPELINE_THREADED
+static int frame_pipeline_worker(void *data) {
+    FramePipeline *pipe = data;
+    for (;;) {
+        SDL_SemWait(pipe->start);
+        if (SDL_AtomicGet(&pipe->quit)) break;
+        pipe->step(pipe->ctx, frame_pipeline_back(pipe));
+        SDL_SemPost(pipe->done);
+    }
+    return 0;
+}
+#endif
+
+bool frame_pipeline_init(FramePipeline *pipe, FramePipelineStep step, void *ctx) {
+    memset(pipe, 0, sizeof(*pipe));
+    pipe->snapshots = mem_calloc(MEM_TAG_UI, 2, sizeof(RenderSnapshot));
+    if (!pipe->snapshots) {
+        debug_log("PIPELINE: Kein Speicher fuer die Render Snapshots");
+        return false;
+    }
+    pipe->step = step;
+    pipe->ctx = ctx;
+
+#ifdef FRAME_PIPELINE_THREADED
+    pipe->start = SDL_CreateSemaphore(0);
+    pipe->done = SDL_CreateSemaphore(0);
+    if (pipe->start && pipe->done) {
+        pipe->worker = SDL_CreateThread(frame_pipeline_worker, "sim_update", pipe);
+    }
+    if (!pipe->worker) {
+        debug_log("PIPELINE: Kein Update-Thread (%s), Update laeuft im Hauptthread", SDL_GetError());
+        if (pipe->start) SDL_DestroySemaphore(pipe->start);
+        if (pipe->done) SDL_DestroySemaphore(pipe->done);
+        pipe->start = NULL;
+        pipe->done = NULL;
+    }
+#endif
+    debug_log("PIPELINE: %u Bytes pro Snapshot, Update %s", (unsigned)sizeof(RenderSnapshot),
+              pipe->worker ? "im eigenen Thread" : "inline");
+    return true;
+}
+
+void frame_pipeline_begin(FramePipeline *pipe) {
+    if (pipe->worker) {
+        pipe->running = true;
+        SDL_SemPost(pipe->start);
+    } else {
+        pipe->step(pipe->ctx, frame_pipeline_back(pipe));
+    }
+}
+
+const RenderSnapshot *frame_pipeline_front(const FramePipeline *pipe) {
+    return &pipe->snapshots[pipe->front];
+}
+
+void frame_pipeline_end(FramePipeline *pipe) {
+    if (pipe->running) {
+        // Time the update still needed after render and present were done
+        PERF_TIMER(pipeline_wait_timer);
+        PERF_BEGIN(pipeline_wait_timer);
+        SDL_SemWait(pipe->done);
+        PERF_END(pipeline_wait_timer);
+        pipe->running = false;
+    }
+    pipe->front ^= 1;
+}
+
+void frame_pipeline_invalidate(FramePipeline *pipe) {
+    pipe->snapshots[0].valid = false;
+    pipe->snapshots[1].valid = false;
+}
+
+void frame_pipeline_cleanup(FramePipeline *pipe) {
+    if (pipe->worker) {
+        if (pipe->running) SDL_SemWait(pipe->done);
+        SDL_AtomicSet(&pipe->quit, 1);
+        SDL_SemPost(pipe->start);
+        SDL_WaitThread(pipe->worker, NULL);
+        SDL_DestroySemaphore(pipe->start);
+        SDL_DestroySemaphore(pipe->done);
+    }
+    mem_free(pipe->snapshots);
+    memset(pipe, 0, sizeof(*pipe));
+}
@@ -0,0 +1,48 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "renderSnapshot.h"
+
+// Simulation step of one frame: updates the game and records what to draw into out
+typedef void (*FramePipelineStep)(void *ctx, RenderSnapshot *out);
+
+/*
+ * Double-buffered render snapshots. While the renderer draws and presents
+ * the front snapshot (frame N), the step for frame N+1 fills the back one
+ * on a worker thread. On the PSP that thread mostly runs while the main
+ * thread waits for the GE and the vblank in SDL_RenderPresent.
+ *
+ * Everything that touches the renderer or loads assets (level changes,
+ * music switches) stays on the main thread between frame_pipeline_end and
+ * the next frame_pipeline_begin, when the step is idle.
+ *
+ * Without FRAME_PIPELINE_THREADED (or if the thread cannot be created) the
+ * step runs inline in frame_pipeline_begin, with the same one-frame delay.
+ */
+typedef struct FramePipeline {
+    RenderSnapshot *snapshots;   // [2], too big for the stack
+    int front;
+    FramePipelineStep step;
+    void *ctx;
+
+    SDL_Thread *worker;
+    SDL_sem *start;
+    SDL_sem *done;
+    SDL_atomic_t quit;
+    bool running;                // step started and not yet waited for
+} FramePipeline;
+
+bool frame_pipeline_init(FramePipeline *pipe, FramePipelineStep step, void *ctx);
+// Starts the step for the next frame
+void frame_pipeline_begin(FramePipeline *pipe);
+// Snapshot to draw this frame; check valid before use
+const RenderSnapshot *frame_pipeline_front(const FramePipeline *pipe);
+// Waits for the step, its snapshot becomes the front of the next frame
+void frame_pipeline_end(FramePipeline *pipe);
+// Drops both snapshots (they point at textures of an unloaded level), only between end and begin
+void frame_pipeline_invalidate(FramePipeline *pipe);
+void frame_pipeline_cleanup(FramePipeline *pipe);
+
+#endif
@@ -0,0 +1,60 @@
+#include "qualityGovernor.h"
+
+extern void debug_log(const char *format, ...);
+
+// Weight of a new sample in the running averages
+#define QUALITY_AVERAGE_WEIGHT 0.125
+
+static const char *quality_names[QUALITY_LEVEL_COUNT] = {
+    "voll", "Parallax halbe Rate", "ferne Gegner halbe Animationsrate", "ohne Lebensbalken", "ohne Effekte"
+};
+
+static QualityLevel g_level = QUALITY_FULL;
+static double g_interval_ms = QUALITY_TARGET_MS;
+static double g_busy_ms = 0.0;
+static int g_frames_since_change = 0;
+static int g_headroom_frames = 0;
+static bool g_skip = true;   // the first interval includes startup
+
+static void quality_set(QualityLevel level) {
+    debug_log("QUALITY: %s -> %s (Frame %.2f ms, Arbeit %.2f ms)",
+              quality_names[g_level], quality_names[level], g_interval_ms, g_busy_ms);
+    g_level = level;
+    g_frames_since_change = 0;
+    g_headroom_frames = 0;
+    // Start over from the target, the old average belongs to the old level
+    g_interval_ms = QUALITY_TARGET_MS;
+}
+
+void quality_governor_frame(Uint64 interval_ticks, Uint64 present_wait_ticks) {
+    if (g_skip) {
+        g_skip = false;
+        return;
+    }
+
+    double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+    double interval = interval_ticks * ms_per_tick;
+    double busy = (interval_ticks > present_wait_ticks ? interval_ticks - present_wait_ticks : 0) * ms_per_tick;
+    g_interval_ms += (interval - g_interval_ms) * QUALITY_AVERAGE_WEIGHT;
+    g_busy_ms += (busy - g_busy_ms) * QUALITY_AVERAGE_WEIGHT;
+    g_frames_since_change++;
+
+    if (g_interval_ms > QUALITY_DEGRADE_MS) {
+        g_headroom_frames = 0;
+        if (g_level + 1 < QUALITY_LEVEL_COUNT && g_frames_since_change >= QUALITY_HOLD_FRAMES) quality_set(g_level + 1);
+        return;
+    }
+
+    // Recover one step at a time, only after a long stretch well inside the budget
+    if (g_busy_ms < QUALITY_RECOVER_MS) g_headroom_frames++;
+    else g_headroom_frames = 0;
+    if (g_level > QUALITY_FULL && g_headroom_frames >= QUALITY_RECOVER_FRAMES) quality_set(g_level - 1);
+}
+
+void quality_governor_skip(void) {
+    g_skip = true;
+}
+
+QualityLevel quality_level(void) {
+    return g_level;
+}
@@ -0,0 +1,43 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+// Frame budget at FRAME_CLOCK_HZ
+#define QUALITY_TARGET_MS 16.67
+// Averaged frame interval above this: one step down
+#define QUALITY_DEGRADE_MS 18.0
+// Averaged work per frame (interval minus the vsync wait in present) below this: one step up
+#define QUALITY_RECOVER_MS 12.0
+// Frames after a change before the next step down, frames of headroom before a step up
+#define QUALITY_HOLD_FRAMES 60
+#define QUALITY_RECOVER_FRAMES 180
+
+// Steps in the order they are taken; each level includes the ones before it
+typedef enum {
+    QUALITY_FULL,
+    QUALITY_FAR_HALF_RATE,      // far parallax composite redrawn every other frame
+    QUALITY_DISTANT_HALF_RATE,  // on-screen enemies away from the player animate every other frame
+    QUALITY_NO_HEALTH_BARS,
+    QUALITY_NO_COSMETICS,       // death animations are not drawn
+    QUALITY_LEVEL_COUNT
+} QualityLevel;
+
+/*
+ * Keeps frames inside the budget on crowded screens by trading detail for
+ * time, and gives it back once there is headroom again. The level changes
+ * only in quality_governor_frame, on the main thread before the update of
+ * the frame starts, so update and render see one level per frame.
+ */
+// Once per frame: interval since the last call and the part of it spent waiting in SDL_RenderPresent
+void quality_governor_frame(Uint64 interval_ticks, Uint64 present_wait_ticks);
+// The next sample is not representative (level load), it is dropped
+void quality_governor_skip(void);
+QualityLevel quality_level(void);
+
+static inline bool quality_at_least(QualityLevel level) {
+    return quality_level() >= level;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "renderSnapshot.h"
+#include "../texture/textureResidency.h"
+
+extern void debug_log(const char *format, ...);
+
+void render_snapshot_begin(RenderSnapshot *snap, int camera_x, int camera_y, Uint32 tick) {
+    snap->valid = true;
+    snap->camera_x = camera_x;
+    snap->camera_y = camera_y;
+    snap->tick = tick;
+    snap->recording_sub = RENDER_SUB_OTHER;
+    snap->item_count = 0;
+    snap->dropped = 0;
+}
+
+static RenderItem *render_snapshot_push(RenderSnapshot *snap) {
+    if (snap->item_count >= RENDER_SNAPSHOT_MAX_ITEMS) {
+        snap->dropped++;
+        return NULL;
+    }
+    RenderItem *item = &snap->items[snap->item_count++];
+    item->sub = snap->recording_sub;
+    return item;
+}
+
+RenderItem *render_snapshot_sprite(RenderSnapshot *snap, SDL_Texture *texture, const SDL_Rect *dst, SDL_RendererFlip flip) {
+    if (!texture) return NULL;
+    RenderItem *item = render_snapshot_push(snap);
+    if (!item) return NULL;
+    item->texture = texture;
+    item->clip = NULL;
+    item->dst = *dst;
+    item->color = (SDL_Color){ 255, 255, 255, 255 };
+    item->kind = RENDER_ITEM_SPRITE;
+    item->flip = (Uint8)flip;
+    return item;
+}
+
+RenderItem *render_snapshot_frame(RenderSnapshot *snap, const SpriteFrameArray *frames, int frame, const SDL_Rect *dst, SDL_RendererFlip flip) {
+    if (frame < 0 || frame >= frames->count) return NULL;
+    if (!frames->clip) return render_snapshot_sprite(snap, frames->frames[frame], dst, flip);
+
+    RenderItem *item = render_snapshot_push(snap);
+    if (!item) return NULL;
+    item->texture = NULL;
+    item->clip = frames->clip;
+    item->frame = frame;
+    item->dst = *dst;
+    item->color = (SDL_Color){ 255, 255, 255, 255 };
+    item->kind = RENDER_ITEM_SPRITE;
+    item->flip = (Uint8)flip;
+    return item;
+}
+
+void render_snapshot_rect(RenderSnapshot *snap, const SDL_Rect *rect, Uint8 r, Uint8 g, Uint8 b, bool fill) {
+    RenderItem *item = render_snapshot_push(snap);
+    if (!item) return;
+    item->texture = NULL;
+    item->clip = NULL;
+    item->dst = *rect;
+    item->color = (SDL_Color){ r, g, b, 255 };
+    item->kind = fill ? RENDER_ITEM_FILL : RENDER_ITEM_OUTLINE;
+    item->flip = SDL_FLIP_NONE;
+}
+
+void render_snapshot_submit(SDL_Renderer *renderer, const RenderSnapshot *snap) {
+    for (int i = 0; i < snap->item_count; i++) {
+        const RenderItem *item = &snap->items[i];
+        if (item->kind == RENDER_ITEM_SPRITE) {
+            SDL_Texture *texture = item->clip ? texture_clip_frame(renderer, item->clip, item->frame) : item->texture;
+            if (!texture) continue;
+            // Frames are shared by every instance of a type, so the mods are set before every copy
+            render_set_color_mod(item->sub, texture, item->color.r, item->color.g, item->color.b);
+            render_set_alpha_mod(item->sub, texture, item->color.a);
+            render_copy_ex(renderer, item->sub, texture, NULL, &item->dst, (SDL_RendererFlip)item->flip);
+        } else {
+            render_set_draw_color(renderer, item->sub, item->color.r, item->color.g, item->color.b, item->color.a);
+            if (item->kind == RENDER_ITEM_FILL) render_fill_rect(renderer, item->sub, &item->dst);
+            else render_draw_rect(renderer, item->sub, &item->dst);
+        }
+    }
+
+    if (snap->dropped > 0) {
+        static int dropped_calls = 0;
+        if (dropped_calls++ % 300 == 0) {
+            debug_log("RENDER_SNAPSHOT: %d Items ueber dem Limit %d verworfen", snap->dropped, RENDER_SNAPSHOT_MAX_ITEMS);
+        }
+    }
+}
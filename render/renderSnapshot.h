@@ -0,0 +1,69 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "../player/player.h"
+#include "../entity/spriteFramesArray.h"
+#include "renderStats.h"
+
+// Bench builds (100 enemies with health bars, 500 projectiles) stay below this
+#define RENDER_SNAPSHOT_MAX_ITEMS 2048
+
+typedef enum {
+    RENDER_ITEM_SPRITE,
+    RENDER_ITEM_FILL,      // SDL_RenderFillRect in color
+    RENDER_ITEM_OUTLINE    // SDL_RenderDrawRect in color
+} RenderItemKind;
+
+// One draw call, already resolved to its animation frame and to screen space
+typedef struct RenderItem {
+    SDL_Texture *texture;
+    struct TextureClip *clip;  // lazy clip instead of texture, resolved (and loaded) at submit
+    int frame;
+    SDL_Rect dst;
+    SDL_Color color;       // sprites: color and alpha mod, rects: draw color
+    Uint8 kind;
+    Uint8 flip;            // SDL_RendererFlip
+    Uint8 sub;             // RenderSubsystem that recorded it
+} RenderItem;
+
+/*
+ * What the renderer needs from the simulation for one frame. The update
+ * writes it at the end of its tick, the renderer only reads it, so drawing
+ * never touches live player / enemy / projectile state (render/framePipeline.h).
+ * Backgrounds and map tiles are not recorded: they only depend on the camera.
+ */
+typedef struct RenderSnapshot {
+    bool valid;            // false until the first update after a level change
+    bool game_over;
+    int camera_x, camera_y;
+    Uint32 tick;
+    Uint64 input_sampled_at; // performance counter of the pad sample when this tick saw a press, else 0
+
+    // HUD, redrawn into its render target only when hud_dirty
+    bool hud_dirty;
+    int health;
+    Item inventory[MAX_INVENTORY];
+    int inventory_count;
+
+    Uint8 recording_sub;   // RenderSubsystem of the items recorded next
+    int item_count;
+    int dropped;           // items past RENDER_SNAPSHOT_MAX_ITEMS this frame
+    RenderItem items[RENDER_SNAPSHOT_MAX_ITEMS];
+} RenderSnapshot;
+
+void render_snapshot_begin(RenderSnapshot *snap, int camera_x, int camera_y, Uint32 tick);
+// Items recorded from here on are counted for sub by the render statistics (RENDER_SUB_OTHER after begin)
+static inline void render_snapshot_subsystem(RenderSnapshot *snap, RenderSubsystem sub) {
+    snap->recording_sub = (Uint8)sub;
+}
+// Returns the recorded item (color starts white / opaque) or NULL when the snapshot is full
+RenderItem *render_snapshot_sprite(RenderSnapshot *snap, SDL_Texture *texture, const SDL_Rect *dst, SDL_RendererFlip flip);
+// Frame of an animation; lazy clips are only looked up on the main thread
+RenderItem *render_snapshot_frame(RenderSnapshot *snap, const SpriteFrameArray *frames, int frame, const SDL_Rect *dst, SDL_RendererFlip flip);
+void render_snapshot_rect(RenderSnapshot *snap, const SDL_Rect *rect, Uint8 r, Uint8 g, Uint8 b, bool fill);
+// Draws the items in recording order, loading lazy clips that are not resident (a stall)
+void render_snapshot_submit(SDL_Renderer *renderer, const RenderSnapshot *snap);
+
+#endif
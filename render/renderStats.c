@@ -0,0 +1,226 @@
+#include "renderStats.h"
+
+#ifdef PERF_ENABLED
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <SDL_ttf.h>
+#include "../assets/assetPack.h"
+#include "../debug/perf.h"
+
+extern void debug_log(const char *format, ...);
+
+#define RENDER_STATS_FONT "resources/fonts/ARIAL.TTF"
+#define RENDER_STATS_FONT_SIZE 10
+// Overlay text is rendered again every this many frames, TTF is too slow for every frame
+#define RENDER_STATS_OVERLAY_FRAMES 30
+#define RENDER_STATS_OVERLAY_X 4
+#define RENDER_STATS_OVERLAY_Y 150
+
+static const char *g_sub_names[RENDER_SUB_COUNT] = {
+    "Other", "Background", "Map", "Enemies", "Projectiles", "Player", "Interactables", "UI"
+};
+
+static RenderStats g_frame[RENDER_SUB_COUNT];     // frame in progress
+static RenderStats g_last[RENDER_SUB_COUNT];      // last finished frame, for the overlay
+static RenderStats g_interval[RENDER_SUB_COUNT];  // since the last log line
+static RenderStats g_run[RENDER_SUB_COUNT];
+static Uint32 g_interval_frames = 0;
+static Uint32 g_run_frames = 0;
+static SDL_Texture *g_bound = NULL;               // texture of the previous draw, NULL after a rect or clear
+
+static TTF_Font *g_font = NULL;
+static bool g_font_failed = false;
+static SDL_Texture *g_overlay = NULL;
+static int g_overlay_w = 0, g_overlay_h = 0;
+static Uint32 g_overlay_age = RENDER_STATS_OVERLAY_FRAMES;
+
+static Uint64 render_stats_area(SDL_Renderer *renderer, const SDL_Rect *rect) {
+    SDL_Rect viewport, visible;
+    SDL_RenderGetViewport(renderer, &viewport);
+    viewport.x = viewport.y = 0;
+    if (!rect) return (Uint64)viewport.w * viewport.h;
+    if (!SDL_IntersectRect(rect, &viewport, &visible)) return 0;
+    return (Uint64)visible.w * visible.h;
+}
+
+static void render_stats_draw(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *dst) {
+    RenderStats *s = &g_frame[sub];
+    s->draws++;
+    if (texture && texture != g_bound) s->binds++;
+    g_bound = texture;
+    s->pixels += render_stats_area(renderer, dst);
+}
+
+static void render_stats_mod(RenderSubsystem sub, bool changed) {
+    if (changed) g_frame[sub].mod_changes++;
+    else g_frame[sub].mod_redundant++;
+}
+
+int render_copy(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst) {
+    render_stats_draw(renderer, sub, texture, dst);
+    return SDL_RenderCopy(renderer, texture, src, dst);
+}
+
+int render_copy_ex(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                   SDL_RendererFlip flip) {
+    render_stats_draw(renderer, sub, texture, dst);
+    return SDL_RenderCopyEx(renderer, texture, src, dst, 0.0, NULL, flip);
+}
+
+int render_fill_rect(SDL_Renderer *renderer, RenderSubsystem sub, const SDL_Rect *rect) {
+    render_stats_draw(renderer, sub, NULL, rect);
+    return SDL_RenderFillRect(renderer, rect);
+}
+
+int render_draw_rect(SDL_Renderer *renderer, RenderSubsystem sub, const SDL_Rect *rect) {
+    // Only the outline is covered
+    RenderStats *s = &g_frame[sub];
+    s->draws++;
+    g_bound = NULL;
+    if (rect) s->pixels += 2 * ((Uint64)rect->w + rect->h);
+    return SDL_RenderDrawRect(renderer, rect);
+}
+
+int render_clear(SDL_Renderer *renderer, RenderSubsystem sub) {
+    render_stats_draw(renderer, sub, NULL, NULL);
+    return SDL_RenderClear(renderer);
+}
+
+int render_set_color_mod(RenderSubsystem sub, SDL_Texture *texture, Uint8 r, Uint8 g, Uint8 b) {
+    Uint8 old_r, old_g, old_b;
+    SDL_GetTextureColorMod(texture, &old_r, &old_g, &old_b);
+    render_stats_mod(sub, old_r != r || old_g != g || old_b != b);
+    return SDL_SetTextureColorMod(texture, r, g, b);
+}
+
+int render_set_alpha_mod(RenderSubsystem sub, SDL_Texture *texture, Uint8 a) {
+    Uint8 old_a;
+    SDL_GetTextureAlphaMod(texture, &old_a);
+    render_stats_mod(sub, old_a != a);
+    return SDL_SetTextureAlphaMod(texture, a);
+}
+
+int render_set_draw_color(SDL_Renderer *renderer, RenderSubsystem sub, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    Uint8 old_r, old_g, old_b, old_a;
+    SDL_GetRenderDrawColor(renderer, &old_r, &old_g, &old_b, &old_a);
+    render_stats_mod(sub, old_r != r || old_g != g || old_b != b || old_a != a);
+    return SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+int render_set_target(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *target) {
+    g_frame[sub].targets++;
+    // The next copy binds its texture again on the new target
+    g_bound = NULL;
+    return SDL_SetRenderTarget(renderer, target);
+}
+
+static void render_stats_add(RenderStats *to, const RenderStats *from) {
+    to->draws += from->draws;
+    to->binds += from->binds;
+    to->mod_changes += from->mod_changes;
+    to->mod_redundant += from->mod_redundant;
+    to->targets += from->targets;
+    to->pixels += from->pixels;
+}
+
+static void render_stats_log(const RenderStats stats[], Uint32 frames) {
+    RenderStats sum = {0};
+    for (int i = 0; i < RENDER_SUB_COUNT; i++) {
+        const RenderStats *s = &stats[i];
+        render_stats_add(&sum, s);
+        if (s->draws == 0 && s->mod_changes == 0 && s->mod_redundant == 0 && s->targets == 0) continue;
+        debug_log("RENDER_STATS: %-13s %5.1f Draws, %5.1f Binds, %5.1f Mods (+%.1f unveraendert), %.1f Targets, %u Pixel",
+                  g_sub_names[i], (double)s->draws / frames, (double)s->binds / frames,
+                  (double)s->mod_changes / frames, (double)s->mod_redundant / frames,
+                  (double)s->targets / frames, (unsigned)(s->pixels / frames));
+    }
+    debug_log("RENDER_STATS: %-13s %5.1f Draws, %5.1f Binds, %5.1f Mods (+%.1f unveraendert), %.1f Targets, %u Pixel",
+              "Gesamt", (double)sum.draws / frames, (double)sum.binds / frames,
+              (double)sum.mod_changes / frames, (double)sum.mod_redundant / frames,
+              (double)sum.targets / frames, (unsigned)(sum.pixels / frames));
+}
+
+void render_stats_frame_end(void) {
+    for (int i = 0; i < RENDER_SUB_COUNT; i++) {
+        render_stats_add(&g_interval[i], &g_frame[i]);
+        render_stats_add(&g_run[i], &g_frame[i]);
+    }
+    memcpy(g_last, g_frame, sizeof(g_last));
+    memset(g_frame, 0, sizeof(g_frame));
+    g_bound = NULL;
+    g_run_frames++;
+    g_overlay_age++;
+
+    if (++g_interval_frames >= PERF_REPORT_INTERVAL) {
+        debug_log("RENDER_STATS: Mittel ueber %u Frames", (unsigned)g_interval_frames);
+        render_stats_log(g_interval, g_interval_frames);
+        memset(g_interval, 0, sizeof(g_interval));
+        g_interval_frames = 0;
+    }
+}
+
+static void render_stats_overlay_refresh(SDL_Renderer *renderer) {
+    if (!g_font && !g_font_failed) {
+        if (!TTF_WasInit() && TTF_Init() < 0) {
+            g_font_failed = true;
+        } else {
+            g_font = TTF_OpenFontRW(asset_open(RENDER_STATS_FONT), 1, RENDER_STATS_FONT_SIZE);
+            g_font_failed = g_font == NULL;
+        }
+        if (g_font_failed) debug_log("RENDER_STATS: Overlay ohne Font (%s)", TTF_GetError());
+    }
+    if (!g_font) return;
+
+    // One line per subsystem that drew: draws / binds / mods / targets / kilopixels
+    char text[RENDER_SUB_COUNT * 64 + 64];
+    int len = snprintf(text, sizeof(text), "Draw Bind Mod Tgt kPx");
+    for (int i = 0; i < RENDER_SUB_COUNT && len < (int)sizeof(text); i++) {
+        const RenderStats *s = &g_last[i];
+        if (s->draws == 0 && s->targets == 0) continue;
+        len += snprintf(text + len, sizeof(text) - len, "\n%s %u %u %u %u %u", g_sub_names[i],
+                        (unsigned)s->draws, (unsigned)s->binds, (unsigned)s->mod_changes,
+                        (unsigned)s->targets, (unsigned)(s->pixels / 1000));
+    }
+
+    SDL_Surface *surface = TTF_RenderText_Blended_Wrapped(g_font, text, (SDL_Color){ 255, 255, 255, 255 }, 240);
+    if (!surface) return;
+    if (g_overlay) SDL_DestroyTexture(g_overlay);
+    g_overlay = SDL_CreateTextureFromSurface(renderer, surface);
+    g_overlay_w = surface->w;
+    g_overlay_h = surface->h;
+    SDL_FreeSurface(surface);
+}
+
+void render_stats_overlay(SDL_Renderer *renderer) {
+    if (g_overlay_age >= RENDER_STATS_OVERLAY_FRAMES) {
+        render_stats_overlay_refresh(renderer);
+        g_overlay_age = 0;
+    }
+    if (!g_overlay) return;
+
+    // Plain SDL calls: the overlay must not show up in its own numbers
+    SDL_Rect dst = { RENDER_STATS_OVERLAY_X, RENDER_STATS_OVERLAY_Y, g_overlay_w, g_overlay_h };
+    SDL_Rect back = { dst.x - 2, dst.y - 2, dst.w + 4, dst.h + 4 };
+    Uint8 old_r, old_g, old_b, old_a;
+    SDL_GetRenderDrawColor(renderer, &old_r, &old_g, &old_b, &old_a);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &back);
+    SDL_SetRenderDrawColor(renderer, old_r, old_g, old_b, old_a);
+    SDL_RenderCopy(renderer, g_overlay, NULL, &dst);
+}
+
+void render_stats_report(const char *label) {
+    debug_log("RENDER_STATS: === %s === Mittel ueber %u Frames", label, (unsigned)g_run_frames);
+    if (g_run_frames > 0) render_stats_log(g_run, g_run_frames);
+}
+
+void render_stats_cleanup(void) {
+    if (g_overlay) SDL_DestroyTexture(g_overlay);
+    g_overlay = NULL;
+    if (g_font) TTF_CloseFont(g_font);
+    g_font = NULL;
+    g_font_failed = false;
+    if (TTF_WasInit()) TTF_Quit();
+}
+#endif
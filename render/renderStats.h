@@ -0,0 +1,97 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <SDL.h>
+
+// Who issued a draw; snapshot items carry the subsystem that recorded them
+typedef enum {
+    RENDER_SUB_OTHER,          // frame clears, anything not attributed
+    RENDER_SUB_BACKGROUND,
+    RENDER_SUB_MAP,
+    RENDER_SUB_ENEMIES,        // sprites and health bars
+    RENDER_SUB_PROJECTILES,
+    RENDER_SUB_PLAYER,
+    RENDER_SUB_INTERACTABLES,  // chest and the door / chest hints
+    RENDER_SUB_UI,
+    RENDER_SUB_COUNT
+} RenderSubsystem;
+
+typedef struct {
+    Uint32 draws;              // copies, fills, outlines and clears
+    Uint32 binds;              // copies from another texture than the draw before
+    Uint32 mod_changes;        // color / alpha mod or draw color set to a new value
+    Uint32 mod_redundant;      // set to the value it already had
+    Uint32 targets;            // render target switches
+    Uint64 pixels;             // destination area inside the viewport
+} RenderStats;
+
+/*
+ * Thin wrappers around the SDL render calls of the game. In PERF builds they
+ * count per subsystem what batching would have to reduce: draw calls,
+ * texture switches between consecutive draws, state changes and covered
+ * pixels. render_stats_frame_end folds the frame into the averages, which
+ * go to the debug log every PERF_REPORT_INTERVAL frames and onto the
+ * overlay. Without PERF_ENABLED the wrappers are the plain SDL calls.
+ *
+ * Main thread only, like every other render call.
+ */
+#ifdef PERF_ENABLED
+int render_copy(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst);
+int render_copy_ex(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                   SDL_RendererFlip flip);
+int render_fill_rect(SDL_Renderer *renderer, RenderSubsystem sub, const SDL_Rect *rect);
+int render_draw_rect(SDL_Renderer *renderer, RenderSubsystem sub, const SDL_Rect *rect);
+int render_clear(SDL_Renderer *renderer, RenderSubsystem sub);
+int render_set_color_mod(RenderSubsystem sub, SDL_Texture *texture, Uint8 r, Uint8 g, Uint8 b);
+int render_set_alpha_mod(RenderSubsystem sub, SDL_Texture *texture, Uint8 a);
+int render_set_draw_color(SDL_Renderer *renderer, RenderSubsystem sub, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+int render_set_target(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *target);
+
+// Once per frame before present: draws the counters of the last frames (not counted themselves)
+void render_stats_overlay(SDL_Renderer *renderer);
+// Once per frame after present
+void render_stats_frame_end(void);
+// Averages over the whole run into the debug log
+void render_stats_report(const char *label);
+void render_stats_cleanup(void);
+#else
+static inline int render_copy(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst) {
+    (void)sub;
+    return SDL_RenderCopy(renderer, texture, src, dst);
+}
+static inline int render_copy_ex(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                                 SDL_RendererFlip flip) {
+    (void)sub;
+    return SDL_RenderCopyEx(renderer, texture, src, dst, 0.0, NULL, flip);
+}
+static inline int render_fill_rect(SDL_Renderer *renderer, RenderSubsystem sub, const SDL_Rect *rect) {
+    (void)sub;
+    return SDL_RenderFillRect(renderer, rect);
+}
+static inline int render_draw_rect(SDL_Renderer *renderer, RenderSubsystem sub, const SDL_Rect *rect) {
+    (void)sub;
+    return SDL_RenderDrawRect(renderer, rect);
+}
+static inline int render_clear(SDL_Renderer *renderer, RenderSubsystem sub) {
+    (void)sub;
+    return SDL_RenderClear(renderer);
+}
+static inline int render_set_color_mod(RenderSubsystem sub, SDL_Texture *texture, Uint8 r, Uint8 g, Uint8 b) {
+    (void)sub;
+    return SDL_SetTextureColorMod(texture, r, g, b);
+}
+static inline int render_set_alpha_mod(RenderSubsystem sub, SDL_Texture *texture, Uint8 a) {
+    (void)sub;
+    return SDL_SetTextureAlphaMod(texture, a);
+}
+static inline int render_set_draw_color(SDL_Renderer *renderer, RenderSubsystem sub, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    (void)sub;
+    return SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+static inline int render_set_target(SDL_Renderer *renderer, RenderSubsystem sub, SDL_Texture *target) {
+    (void)sub;
+    return SDL_SetRenderTarget(renderer, target);
+}
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+#include "textureFormat.h"
+#include "../assets/assetPack.h"
+#include "../memory/memTrack.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern void debug_log(const char *format, ...);
+
+typedef struct {
+    char path[TEXTURE_PATH_MAX];
+    Uint32 format;
+} TextureFormatEntry;
+
+enum { TEX_STAT_8888, TEX_STAT_5551, TEX_STAT_4444, TEX_STAT_565, TEX_STAT_COUNT };
+
+static const char* tex_stat_names[TEX_STAT_COUNT] = { "8888", "5551", "4444", "565" };
+static const Uint32 tex_stat_formats[TEX_STAT_COUNT] = {
+    SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ABGR1555, SDL_PIXELFORMAT_ABGR4444, SDL_PIXELFORMAT_BGR565
+};
+
+static TextureFormatEntry g_tex_formats[TEXTURE_FORMAT_MAX];
+static int g_tex_format_count = 0;
+static bool g_tex_formats_loaded = false;
+
+// Since the last report
+static int g_tex_created[TEX_STAT_COUNT];
+static Uint32 g_tex_bytes[TEX_STAT_COUNT];
+static Uint32 g_tex_bytes_32bit = 0;
+
+void texture_formats_load(const char* manifest_path) {
+    g_tex_formats_loaded = true;
+    g_tex_format_count = 0;
+
+    SDL_RWops* rw = asset_open(manifest_path);
+    Sint64 size = rw ? SDL_RWsize(rw) : -1;
+    char* text = size >= 0 ? mem_alloc(MEM_TAG_ASSETS, (size_t)size + 1) : NULL;
+    if (!text || SDL_RWread(rw, text, 1, (size_t)size) != (size_t)size) {
+        debug_log("TEXTURE: Kein Manifest %s, alles bleibt 32 bit", manifest_path);
+        mem_free(text);
+        if (rw) SDL_RWclose(rw);
+        return;
+    }
+    SDL_RWclose(rw);
+    text[size] = '\0';
+
+    for (char* line = strtok(text, "\r\n"); line; line = strtok(NULL, "\r\n")) {
+        char path[TEXTURE_PATH_MAX];
+        char name[8];
+        if (line[0] == '#' || sscanf(line, "%127s %7s", path, name) != 2) continue;
+        if (g_tex_format_count >= TEXTURE_FORMAT_MAX) {
+            debug_log("TEXTURE: Manifest voll (%d), Rest bleibt 32 bit", TEXTURE_FORMAT_MAX);
+            break;
+        }
+
+        int stat = -1;
+        for (int i = 0; i < TEX_STAT_COUNT; i++) {
+            if (strcmp(name, tex_stat_names[i]) == 0) stat = i;
+        }
+        if (stat < 0) continue;
+
+        TextureFormatEntry* entry = &g_tex_formats[g_tex_format_count++];
+        snprintf(entry->path, sizeof(entry->path), "%s", path);
+        entry->format = tex_stat_formats[stat];
+    }
+    mem_free(text);
+    debug_log("TEXTURE: %d Formate aus %s", g_tex_format_count, manifest_path);
+}
+
+Uint32 texture_format_for(const char* path) {
+    if (!g_tex_formats_loaded) texture_formats_load(TEXTURE_FORMAT_MANIFEST);
+    if (path) {
+        for (int i = 0; i < g_tex_format_count; i++) {
+            if (strcmp(g_tex_formats[i].path, path) == 0) return g_tex_formats[i].format;
+        }
+    }
+    return SDL_PIXELFORMAT_ABGR8888;
+}
+
+static int next_pow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+static void texture_count(SDL_Texture* texture) {
+    Uint32 format;
+    int w, h;
+    if (SDL_QueryTexture(texture, &format, NULL, &w, &h) != 0) return;
+
+    int stat = TEX_STAT_8888;
+    for (int i = 0; i < TEX_STAT_COUNT; i++) {
+        if (tex_stat_formats[i] == format) stat = i;
+    }
+    // The PSP renderer pads both sides to a power of two
+    Uint32 texels = (Uint32)next_pow2(w) * (Uint32)next_pow2(h);
+    g_tex_created[stat]++;
+    g_tex_bytes[stat] += texels * SDL_BYTESPERPIXEL(format);
+    g_tex_bytes_32bit += texels * 4;
+}
+
+SDL_Texture* texture_create_from_surface(SDL_Renderer* renderer, SDL_Surface* surface, const char* path) {
+    if (!renderer || !surface) return NULL;
+
+    // 8888 assets go through unchanged; SDL picks the matching texture format itself
+    Uint32 format = texture_format_for(path);
+    SDL_Surface* converted = NULL;
+    if (format != SDL_PIXELFORMAT_ABGR8888 && surface->format->format != format) {
+        converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+        if (!converted) debug_log("TEXTURE: Konvertierung %s fehlgeschlagen: %s", path, SDL_GetError());
+    }
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, converted ? converted : surface);
+    mem_track_texture_created(texture);
+    if (converted) SDL_FreeSurface(converted);
+    if (texture) texture_count(texture);
+    return texture;
+}
+
+void texture_memory_report(const char* label) {
+    int count = 0;
+    Uint32 bytes = 0;
+    for (int i = 0; i < TEX_STAT_COUNT; i++) {
+        count += g_tex_created[i];
+        bytes += g_tex_bytes[i];
+    }
+    debug_log("TEXTURE: %s - %d Texturen, %u KB (32 bit: %u KB) [8888 %d, 5551 %d, 4444 %d, 565 %d]",
+              label, count, (unsigned)(bytes / 1024), (unsigned)(g_tex_bytes_32bit / 1024),
+              g_tex_created[TEX_STAT_8888], g_tex_created[TEX_STAT_5551],
+              g_tex_created[TEX_STAT_4444], g_tex_created[TEX_STAT_565]);
+    memset(g_tex_created, 0, sizeof(g_tex_created));
+    memset(g_tex_bytes, 0, sizeof(g_tex_bytes));
+    g_tex_bytes_32bit = 0;
+}
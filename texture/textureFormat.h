@@ -0,0 +1,20 @@
+#ifndef TEXTURE_FORMAT_H
+#define TEXTURE_FORMAT_H
+
+#include <SDL.h>
+
+// Generated by tools/texture_formats.py, one "path format" line per PNG
+#define TEXTURE_FORMAT_MANIFEST "resources/textures.cfg"
+#define TEXTURE_FORMAT_MAX 256
+#define TEXTURE_PATH_MAX 128
+
+// Reads the manifest; called lazily by the first lookup as well
+void texture_formats_load(const char* manifest_path);
+// SDL_PIXELFORMAT_ABGR1555/ABGR4444/BGR565, or ABGR8888 for assets not in the manifest
+Uint32 texture_format_for(const char* path);
+// Converts the surface to the format chosen for path and uploads it; the surface stays owned by the caller
+SDL_Texture* texture_create_from_surface(SDL_Renderer* renderer, SDL_Surface* surface, const char* path);
+// Logs textures/bytes created since the previous report, per format
+void texture_memory_report(const char* label);
+
+#endif
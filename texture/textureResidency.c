@@ -0,0 +1,216 @@
+#include "textureResidency.h"
+#include <stdio.h>
+#include <string.h>
+#include "../assets/assetPack.h"
+#include "../memory/memTrack.h"
+
+extern SDL_Texture *load_texture(SDL_Renderer *renderer, const char *path);
+extern void debug_log(const char *format, ...);
+
+#define TEXTURE_CLIP_PATH_MAX 128
+
+struct TextureClip {
+    bool used;                  // registry slot taken
+    bool single;                // path is the .png itself
+    bool failed;                // a load failed, not retried
+    char path[TEXTURE_CLIP_PATH_MAX];
+    SDL_Texture **frames;       // [count], NULL while evicted, shared with the SpriteFrameArray
+    int count;
+    size_t bytes;               // while resident
+    Uint32 last_used;           // residency frame of the last draw or hint
+    SDL_atomic_t resident;      // read by the update thread
+    SDL_atomic_t hinted;        // set by the update thread, taken by texture_residency_update
+};
+
+typedef struct {
+    int loads_prefetch;
+    int loads_stall;
+    int evictions;
+    int over_budget_frames;     // every resident clip was in use, budget exceeded
+    Uint64 stall_ticks;         // performance counter ticks spent in stalls
+    Uint64 stall_worst;
+} ResidencyStats;
+
+static TextureClip g_clips[TEXTURE_CLIP_MAX];
+static size_t g_budget = (size_t)TEXTURE_BUDGET_KB * 1024;
+static size_t g_resident_bytes = 0;
+static Uint32 g_frame = 1;
+static ResidencyStats g_res;
+
+bool texture_png_size(const char *path, int *w, int *h) {
+    static const Uint8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    Uint8 header[24];
+
+    SDL_RWops *rw = asset_open(path);
+    if (!rw) return false;
+    size_t got = SDL_RWread(rw, header, 1, sizeof(header));
+    SDL_RWclose(rw);
+
+    // Signature, then the IHDR chunk: length, type, big endian width and height
+    if (got != sizeof(header) || memcmp(header, signature, 8) != 0 || memcmp(header + 12, "IHDR", 4) != 0) return false;
+    *w = (int)((Uint32)header[16] << 24 | (Uint32)header[17] << 16 | (Uint32)header[18] << 8 | header[19]);
+    *h = (int)((Uint32)header[20] << 24 | (Uint32)header[21] << 16 | (Uint32)header[22] << 8 | header[23]);
+    return true;
+}
+
+bool texture_clip_register(SpriteFrameArray *out, const char *path, bool single, int count, int w, int h) {
+    TextureClip *clip = NULL;
+    for (int i = 0; i < TEXTURE_CLIP_MAX && !clip; i++) {
+        if (!g_clips[i].used) clip = &g_clips[i];
+    }
+    if (!clip) {
+        debug_log("RESIDENCY: Mehr als %d Clips, %s wird sofort geladen", TEXTURE_CLIP_MAX, path);
+        return false;
+    }
+
+    SDL_Texture **frames = mem_calloc(MEM_TAG_SPRITES, (size_t)count, sizeof(SDL_Texture*));
+    if (!frames) return false;
+
+    memset(clip, 0, sizeof(*clip));
+    clip->used = true;
+    clip->single = single;
+    snprintf(clip->path, sizeof(clip->path), "%s", path);
+    clip->frames = frames;
+    clip->count = count;
+
+    out->frames = frames;
+    out->count = count;
+    out->sprite_w = w;
+    out->sprite_h = h;
+    out->arena_owned = 0;
+    out->clip = clip;
+    return true;
+}
+
+static void texture_clip_evict(TextureClip *clip) {
+    for (int i = 0; i < clip->count; i++) {
+        mem_track_texture_destroy(clip->frames[i]);
+        clip->frames[i] = NULL;
+    }
+    g_resident_bytes -= clip->bytes;
+    clip->bytes = 0;
+    SDL_AtomicSet(&clip->resident, 0);
+}
+
+void texture_clip_release(SpriteFrameArray *a) {
+    TextureClip *clip = a->clip;
+    if (!clip) return;
+    if (SDL_AtomicGet(&clip->resident)) texture_clip_evict(clip);
+    mem_free(clip->frames);
+    clip->used = false;
+    a->clip = NULL;
+    a->frames = NULL;
+    a->count = 0;
+}
+
+static bool texture_clip_load(SDL_Renderer *renderer, TextureClip *clip) {
+    char path[TEXTURE_CLIP_PATH_MAX + 16];
+    size_t bytes = 0;
+
+    for (int i = 0; i < clip->count; i++) {
+        if (clip->single) snprintf(path, sizeof(path), "%s", clip->path);
+        else snprintf(path, sizeof(path), "%s%d.png", clip->path, i + 1);
+        clip->frames[i] = load_texture(renderer, path);
+        if (!clip->frames[i]) {
+            debug_log("RESIDENCY: Fehler beim Laden von %s, Clip bleibt leer", path);
+            for (int j = 0; j < i; j++) {
+                mem_track_texture_destroy(clip->frames[j]);
+                clip->frames[j] = NULL;
+            }
+            clip->failed = true;
+            return false;
+        }
+        bytes += mem_track_texture_bytes(clip->frames[i]);
+    }
+
+    clip->bytes = bytes;
+    clip->last_used = g_frame;
+    g_resident_bytes += bytes;
+    SDL_AtomicSet(&clip->resident, 1);
+    return true;
+}
+
+void texture_clip_prefetch(const SpriteFrameArray *a) {
+    if (a->clip) SDL_AtomicSet(&a->clip->hinted, 1);
+}
+
+SDL_Texture *texture_clip_frame(SDL_Renderer *renderer, TextureClip *clip, int frame) {
+    if (frame < 0 || frame >= clip->count) return NULL;
+
+    if (!SDL_AtomicGet(&clip->resident)) {
+        if (clip->failed) return NULL;
+
+        // The frame cannot be drawn without it: everything after this waits
+        Uint64 start = SDL_GetPerformanceCounter();
+        bool loaded = texture_clip_load(renderer, clip);
+        Uint64 ticks = SDL_GetPerformanceCounter() - start;
+
+        g_res.loads_stall++;
+        g_res.stall_ticks += ticks;
+        if (ticks > g_res.stall_worst) g_res.stall_worst = ticks;
+        debug_log("RESIDENCY: Stall %.2f ms fuer %s (%d Frames)",
+                  ticks * 1000.0 / SDL_GetPerformanceFrequency(), clip->path, clip->count);
+        if (!loaded) return NULL;
+    }
+
+    clip->last_used = g_frame;
+    return clip->frames[frame];
+}
+
+void texture_residency_update(SDL_Renderer *renderer) {
+    int prefetched = 0;
+    for (int i = 0; i < TEXTURE_CLIP_MAX; i++) {
+        TextureClip *clip = &g_clips[i];
+        if (!clip->used || !SDL_AtomicGet(&clip->hinted)) continue;
+
+        if (SDL_AtomicGet(&clip->resident)) {
+            // A hinted clip is about to be drawn, keep it away from eviction
+            SDL_AtomicSet(&clip->hinted, 0);
+            clip->last_used = g_frame;
+        } else if (!clip->failed && prefetched < TEXTURE_PREFETCH_PER_FRAME) {
+            SDL_AtomicSet(&clip->hinted, 0);
+            if (texture_clip_load(renderer, clip)) g_res.loads_prefetch++;
+            prefetched++;
+        }
+    }
+
+    // Least recently drawn first; clips drawn or hinted this frame stay
+    while (g_resident_bytes > g_budget) {
+        TextureClip *oldest = NULL;
+        for (int i = 0; i < TEXTURE_CLIP_MAX; i++) {
+            TextureClip *clip = &g_clips[i];
+            if (!clip->used || !SDL_AtomicGet(&clip->resident) || clip->last_used == g_frame) continue;
+            if (!oldest || clip->last_used < oldest->last_used) oldest = clip;
+        }
+        if (!oldest) {
+            g_res.over_budget_frames++;
+            break;
+        }
+        texture_clip_evict(oldest);
+        g_res.evictions++;
+    }
+
+    g_frame++;
+}
+
+void texture_residency_set_budget(size_t bytes) {
+    g_budget = bytes;
+}
+
+void texture_residency_report(const char *label) {
+    int registered = 0, resident = 0;
+    for (int i = 0; i < TEXTURE_CLIP_MAX; i++) {
+        if (!g_clips[i].used) continue;
+        registered++;
+        if (SDL_AtomicGet(&g_clips[i].resident)) resident++;
+    }
+
+    double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+    debug_log("RESIDENCY: === %s ===", label);
+    debug_log("RESIDENCY: %d/%d Clips resident, %u KB von %u KB Budget",
+              resident, registered, (unsigned)(g_resident_bytes / 1024), (unsigned)(g_budget / 1024));
+    debug_log("RESIDENCY: %d Prefetch-Loads, %d Evictions, %d Frames ueber Budget",
+              g_res.loads_prefetch, g_res.evictions, g_res.over_budget_frames);
+    debug_log("RESIDENCY: %d Stalls, gesamt %.2f ms, laengster %.2f ms",
+              g_res.loads_stall, g_res.stall_ticks * ms_per_tick, g_res.stall_worst * ms_per_tick);
+}
@@ -0,0 +1,48 @@
+#ifndef TEXTURE_RESIDENCY_H
+#define TEXTURE_RESIDENCY_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include "../entity/spriteFramesArray.h"
+
+// Texture memory for lazily loaded animation clips (CMake: TEXTURE_BUDGET_KB)
+#ifndef TEXTURE_BUDGET_KB
+#define TEXTURE_BUDGET_KB 2048
+#endif
+#define TEXTURE_CLIP_MAX 64
+// Prefetched clips loaded per frame, the rest waits for the next frames
+#define TEXTURE_PREFETCH_PER_FRAME 2
+
+/*
+ * Animation clips that are registered instead of loaded: the frame count and
+ * size are known right away, the textures are loaded the first time a frame
+ * is drawn (or earlier on a prefetch hint) and evicted again, least recently
+ * drawn first, when the clips together exceed the budget.
+ *
+ * The update thread only records clip + frame index into the render snapshot
+ * and sends hints; loading, drawing and evicting happen on the main thread.
+ * A frame that draws a clip which is not resident loads it on the spot and
+ * counts as a stall.
+ */
+typedef struct TextureClip TextureClip;
+
+// Registers the clip for path (numbered frames path1.png.. or a single .png)
+// with count frames of w x h and points out at it; returns false when the registry is full
+bool texture_clip_register(SpriteFrameArray *out, const char *path, bool single, int count, int w, int h);
+// Destroys the textures and frees the slot
+void texture_clip_release(SpriteFrameArray *a);
+// Hint from the update thread that the clip is about to be drawn, ignored for eager arrays
+void texture_clip_prefetch(const SpriteFrameArray *a);
+// Main thread only: frame of the clip, loaded first if needed; NULL if the clip failed to load
+SDL_Texture *texture_clip_frame(SDL_Renderer *renderer, TextureClip *clip, int frame);
+
+// Width and height from the PNG header, without decoding the image
+bool texture_png_size(const char *path, int *w, int *h);
+
+// Once per frame after present: loads hinted clips, evicts down to the budget
+void texture_residency_update(SDL_Renderer *renderer);
+void texture_residency_set_budget(size_t bytes);
+// Resident bytes, loads, evictions and stalls into the debug log
+void texture_residency_report(const char *label);
+
+#endif
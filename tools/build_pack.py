@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Bundle the runtime assets into one pack file.
+
+Loose files mean one open + seek per frame PNG on UMD / memory stick. The
+pack is read by assets/assetPack.c instead; loose files are only the
+fallback for paths missing from it.
+
+Layout (little endian):
+
+    "RPAK"  u32 version  u32 entry_count  u32 names_size
+    entry_count x { u32 name_offset  u32 offset  u32 size  u32 stored_size }
+    names (NUL terminated, entries sorted by name for binary search)
+    data
+
+The data is ordered by PACK_ORDER (startup assets, then level by level) so
+a level load reads the file mostly front to back. An entry is deflated
+(zlib) when that saves at least COMPRESS_MIN_GAIN; stored_size == size
+means stored. PNG and OGG are compressed already and end up stored.
+
+    python3 tools/build_pack.py [root] [out_file]
+
+Defaults: . -> resources.pak. Only the standard library is used.
+"""
+import os
+import struct
+import sys
+import zlib
+
+PACK_MAGIC = b"RPAK"
+PACK_VERSION = 1
+EXTENSIONS = (".png", ".json", ".wav", ".ogg", ".cfg", ".bin")
+SKIP_DIRS = ("Gothicvania Collection Files",)
+COMPRESS_MIN_GAIN = 0.10
+
+# Path prefixes in load order; anything unmatched goes before the music
+PACK_ORDER = [
+    # main.c / player_init
+    "resources/textures.cfg",
+    "resources/enemies.cfg",
+    "resources/sfx/",
+    "resources/sprites/player/",
+    "resources/ui/",
+    "resources/sprites/",
+    # level 1: map, tilesets, backgrounds
+    "resources/maps/map_level1.",    # .json, or .chunks/ when split
+    "resources/levels/cemetery/",
+    # level 2
+    "resources/maps/map_level2.",
+    "resources/levels/castle/",
+    None,
+    # streamed while playing, seeks anyway
+    "resources/music/",
+]
+
+
+def collect(root):
+    files = []
+    res_dir = os.path.join(root, "resources")
+    for dirpath, dirnames, filenames in os.walk(res_dir):
+        dirnames[:] = sorted(d for d in dirnames if d not in SKIP_DIRS)
+        for name in sorted(filenames):
+            if not name.lower().endswith(EXTENSIONS):
+                continue
+            # bgm/bgmHandler.c prefers the converted copy in mixer/
+            if os.path.exists(os.path.join(dirpath, "mixer", name)):
+                continue
+            path = os.path.join(dirpath, name)
+            files.append(os.path.relpath(path, root).replace(os.sep, "/"))
+    return files
+
+
+def order_key(path):
+    fallback = PACK_ORDER.index(None)
+    for i, prefix in enumerate(PACK_ORDER):
+        if prefix and path.startswith(prefix):
+            return (i, path)
+    return (fallback, path)
+
+
+def main():
+    root = sys.argv[1] if len(sys.argv) > 1 else "."
+    out = sys.argv[2] if len(sys.argv) > 2 else "resources.pak"
+
+    files = sorted(collect(root), key=order_key)
+
+    blobs = []
+    for path in files:
+        with open(os.path.join(root, path), "rb") as f:
+            raw = f.read()
+        packed = zlib.compress(raw, 9)
+        data = packed if len(packed) <= len(raw) * (1.0 - COMPRESS_MIN_GAIN) else raw
+        blobs.append((path, len(raw), data))
+
+    by_name = sorted(range(len(blobs)), key=lambda i: blobs[i][0].encode())
+    names = b""
+    name_offsets = {}
+    for i in by_name:
+        name_offsets[i] = len(names)
+        names += blobs[i][0].encode() + b"\0"
+
+    data_start = 16 + 16 * len(blobs) + len(names)
+    offsets = []
+    pos = data_start
+    for _, _, data in blobs:
+        offsets.append(pos)
+        pos += len(data)
+
+    with open(out, "wb") as f:
+        f.write(PACK_MAGIC + struct.pack("<III", PACK_VERSION, len(blobs), len(names)))
+        for i in by_name:
+            f.write(struct.pack("<IIII", name_offsets[i], offsets[i], blobs[i][1], len(blobs[i][2])))
+        f.write(names)
+        for _, _, data in blobs:
+            f.write(data)
+
+    raw_total = sum(b[1] for b in blobs)
+    compressed = sum(1 for b in blobs if len(b[2]) < b[1])
+    print("%s: %d entries (%d deflated), %d -> %d bytes" % (out, len(blobs), compressed, raw_total, pos))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Convert sound effects to the format the mixer is opened with.
+
+bgm/bgmHandler.c opens SDL_mixer at 44.1 kHz, 16 bit. Source WAVs that
+differ get resampled here once instead of on every Mix_LoadWAV. Stereo
+files whose channels are (nearly) identical are folded to mono.
+
+    python3 tools/convert_sfx.py [src_dir] [out_dir]
+
+Defaults: resources/sfx -> resources/sfx/mixer. Only the standard library
+is used (wave + audioop, so Python 3.12 or older).
+"""
+import os
+import sys
+import wave
+
+try:
+    import audioop
+except ImportError:
+    sys.exit("convert_sfx: needs the audioop module (Python <= 3.12)")
+
+TARGET_RATE = 44100
+TARGET_WIDTH = 2                 # 16 bit
+MONO_MAX_DIFF = 0.02             # max |L-R| relative to full scale to fold to mono
+
+
+def channels_identical(frames, width):
+    left = audioop.tomono(frames, width, 1, 0)
+    right = audioop.tomono(frames, width, 0, 1)
+    diff = audioop.add(left, audioop.mul(right, width, -1), width)
+    full_scale = (1 << (8 * width - 1)) - 1
+    return audioop.max(diff, width) <= MONO_MAX_DIFF * full_scale
+
+
+def convert(src, dst):
+    with wave.open(src, "rb") as w:
+        channels = src_channels = w.getnchannels()
+        width = w.getsampwidth()
+        rate = w.getframerate()
+        frames = w.readframes(w.getnframes())
+
+    if width != TARGET_WIDTH:
+        frames = audioop.lin2lin(frames, width, TARGET_WIDTH)
+        width = TARGET_WIDTH
+
+    if channels == 2 and channels_identical(frames, width):
+        frames = audioop.tomono(frames, width, 0.5, 0.5)
+        channels = 1
+
+    if rate != TARGET_RATE:
+        frames, _ = audioop.ratecv(frames, width, channels, rate, TARGET_RATE, None)
+
+    with wave.open(dst, "wb") as out:
+        out.setnchannels(channels)
+        out.setsampwidth(width)
+        out.setframerate(TARGET_RATE)
+        out.writeframes(frames)
+
+    layout = {1: "mono", 2: "stereo"}
+    print("%s: %d Hz %s -> %d Hz %s, %d -> %d bytes" % (
+        os.path.basename(src), rate, layout.get(src_channels, "?"),
+        TARGET_RATE, layout.get(channels, "?"),
+        os.path.getsize(src), os.path.getsize(dst)))
+
+
+def main():
+    src_dir = sys.argv[1] if len(sys.argv) > 1 else "resources/sfx"
+    out_dir = sys.argv[2] if len(sys.argv) > 2 else os.path.join(src_dir, "mixer")
+    os.makedirs(out_dir, exist_ok=True)
+
+    for name in sorted(os.listdir(src_dir)):
+        if not name.lower().endswith(".wav"):
+            continue
+        src = os.path.join(src_dir, name)
+        dst = os.path.join(out_dir, name)
+        # Skip up-to-date outputs so the build step stays cheap
+        if os.path.exists(dst) and os.path.getmtime(dst) >= os.path.getmtime(src):
+            continue
+        convert(src, dst)
+
+
+if __name__ == "__main__":
+    main()
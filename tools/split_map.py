@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Split Tiled maps into fixed-size chunks for streaming.
+
+A whole map as cute_tiled DOM does not fit in PSP RAM once a world grows
+past a few screens, so every resources/maps/<name>.json gets a directory
+<name>.chunks/ next to it, which map/mapStream.c streams around the camera:
+
+    world.bin                little endian
+        "RWLD"  u32 version  u16 width  u16 height  (tiles)
+        u16 chunk_tiles  u16 layer_count  u16 tileset_count  u16 tile_size
+        tileset_count x { u32 firstgid  u8 collision  u8 pad[3] }
+
+    chunk_<cx>_<cy>.bin      chunk_tiles^2 u16 gids per plane
+        collision plane, then layer_count render layers in map order
+
+Gids lose their flip bits (the renderer ignores them). Chunks past the map
+edge are padded with 0, chunks without any tile are not written: the game
+treats a missing chunk file as empty. The spawn markers stay in the
+collision plane, so spawn data travels with its chunk.
+
+    python3 tools/split_map.py [root]
+
+Only the standard library is used.
+"""
+import base64
+import glob
+import json
+import os
+import struct
+import sys
+import zlib
+
+WORLD_MAGIC = b"RWLD"
+WORLD_VERSION = 1
+CHUNK_TILES = 32          # MAP_CHUNK_TILES in map/mapStream.h
+GID_MASK = 0x1FFFFFFF
+COLLISION_LAYER = "Collision"
+
+
+def layer_gids(layer):
+    data = layer["data"]
+    if layer.get("encoding") != "base64":
+        return [g & GID_MASK for g in data]
+    raw = base64.b64decode(data)
+    if layer.get("compression") in ("zlib", "gzip"):
+        raw = zlib.decompress(raw, 47)
+    elif layer.get("compression"):
+        raise ValueError("compression %s not supported" % layer["compression"])
+    return [g & GID_MASK for g in struct.unpack("<%dI" % (len(raw) // 4), raw)]
+
+
+def chunk_plane(gids, width, height, cx, cy):
+    plane = []
+    for y in range(cy * CHUNK_TILES, (cy + 1) * CHUNK_TILES):
+        for x in range(cx * CHUNK_TILES, (cx + 1) * CHUNK_TILES):
+            plane.append(gids[y * width + x] if x < width and y < height else 0)
+    return plane
+
+
+def split(path):
+    with open(path) as f:
+        tmap = json.load(f)
+    if tmap.get("infinite"):
+        raise ValueError("infinite maps are not supported")
+    width, height = tmap["width"], tmap["height"]
+
+    collision = None
+    layers = []
+    for layer in tmap["layers"]:
+        if layer["type"] != "tilelayer":
+            continue
+        gids = layer_gids(layer)
+        if len(gids) != width * height:
+            raise ValueError("layer %s is not map sized" % layer["name"])
+        if layer["name"] == COLLISION_LAYER:
+            collision = gids
+        else:
+            layers.append(gids)
+    if collision is None:
+        collision = [0] * (width * height)
+
+    for g in collision + [g for plane in layers for g in plane]:
+        if g > 0xFFFF:
+            raise ValueError("gid %d does not fit in 16 bit" % g)
+
+    out_dir = os.path.splitext(path)[0] + ".chunks"
+    os.makedirs(out_dir, exist_ok=True)
+    for old in glob.glob(os.path.join(out_dir, "chunk_*.bin")):
+        os.remove(old)
+
+    tilesets = tmap["tilesets"]
+    with open(os.path.join(out_dir, "world.bin"), "wb") as f:
+        f.write(WORLD_MAGIC + struct.pack("<IHHHHHH", WORLD_VERSION, width, height, CHUNK_TILES,
+                                          len(layers), len(tilesets), tmap["tilewidth"]))
+        for ts in tilesets:
+            is_collision = "collision" in ts.get("name", "").lower()
+            f.write(struct.pack("<IB3x", ts["firstgid"], 1 if is_collision else 0))
+
+    chunks_x = (width + CHUNK_TILES - 1) // CHUNK_TILES
+    chunks_y = (height + CHUNK_TILES - 1) // CHUNK_TILES
+    written = 0
+    for cy in range(chunks_y):
+        for cx in range(chunks_x):
+            planes = [chunk_plane(p, width, height, cx, cy) for p in [collision] + layers]
+            if not any(any(p) for p in planes):
+                continue
+            with open(os.path.join(out_dir, "chunk_%d_%d.bin" % (cx, cy)), "wb") as f:
+                for p in planes:
+                    f.write(struct.pack("<%dH" % len(p), *p))
+            written += 1
+
+    print("%s: %dx%d tiles, %d layers -> %d of %dx%d chunks" % (
+        path, width, height, len(layers), written, chunks_x, chunks_y))
+
+
+def main():
+    root = sys.argv[1] if len(sys.argv) > 1 else "."
+    for path in sorted(glob.glob(os.path.join(root, "resources", "maps", "*.json"))):
+        stamp = os.path.join(os.path.splitext(path)[0] + ".chunks", "world.bin")
+        # Skip when nothing changed so the build step stays cheap
+        if os.path.exists(stamp) and os.path.getmtime(stamp) >= os.path.getmtime(path):
+            continue
+        try:
+            split(path)
+        except (ValueError, KeyError) as e:
+            print("%s: skipped (%s)" % (path, e))
+
+
+if __name__ == "__main__":
+    main()
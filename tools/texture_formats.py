@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""Pick a low bit depth texture format for every PNG the game loads.
+
+The PSP renderer keeps textures as ABGR8888, ABGR1555, ABGR4444 or BGR565
+(no paletted formats), so most of the pixel art - few colors, hard alpha -
+fits in 16 bit without visible change. Each image is quantized to the
+candidate formats and the first one that passes the visual-diff check wins:
+
+    565   opaque image
+    5551  alpha only 0 / 255
+    4444  graded alpha
+    8888  fallback
+
+The check: no two distinct visible colors may collapse into one (pixel art
+relies on every palette entry), and the worst channel error must stay
+within one quantization step. Images with more than PHOTO_COLORS colors
+are painted backgrounds; there collapses are tolerated as long as the PSNR
+stays above PHOTO_MIN_PSNR.
+
+    python3 tools/texture_formats.py [root] [--diff DIR]
+
+Writes <root>/resources/textures.cfg ("path format" per line), which
+texture/textureFormat.c reads at startup. --diff DIR additionally writes
+original | quantized | error x8 strips for eyeballing. Only the standard
+library is used.
+"""
+import math
+import os
+import struct
+import sys
+import zlib
+
+SKIP_DIRS = ("Gothicvania Collection Files",)   # source packs, not loaded by the game
+MANIFEST = os.path.join("resources", "textures.cfg")
+PHOTO_COLORS = 64
+PHOTO_MIN_PSNR = 38.0
+
+# bits per channel (r, g, b, a)
+FORMATS = {
+    "565":  (5, 6, 5, 0),
+    "5551": (5, 5, 5, 1),
+    "4444": (4, 4, 4, 4),
+}
+
+
+# --- PNG decoding -----------------------------------------------------------
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def unfilter(raw, width, height, bpp, stride):
+    out = bytearray(height * stride)
+    prev = bytearray(stride)
+    pos = 0
+    for y in range(height):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        if ftype == 1:
+            for i in range(bpp, stride):
+                line[i] = (line[i] + line[i - bpp]) & 0xFF
+        elif ftype == 2:
+            for i in range(stride):
+                line[i] = (line[i] + prev[i]) & 0xFF
+        elif ftype == 3:
+            for i in range(stride):
+                left = line[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + ((left + prev[i]) >> 1)) & 0xFF
+        elif ftype == 4:
+            for i in range(stride):
+                left = line[i - bpp] if i >= bpp else 0
+                up_left = prev[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + paeth(left, prev[i], up_left)) & 0xFF
+        out[y * stride:(y + 1) * stride] = line
+        prev = line
+    return out
+
+
+def load_png(path):
+    """Returns (width, height, rgba bytes, description) or raises ValueError."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("not a png")
+
+    pos = 8
+    idat = []
+    palette = trns = None
+    while pos < len(data):
+        length, ctype = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if ctype == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif ctype == b"PLTE":
+            palette = body
+        elif ctype == b"tRNS":
+            trns = body
+        elif ctype == b"IDAT":
+            idat.append(body)
+        elif ctype == b"IEND":
+            break
+
+    if interlace:
+        raise ValueError("interlaced")
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    if depth != 8 and not (color in (0, 3) and depth < 8):
+        raise ValueError("%d bit" % depth)
+
+    bits = depth * channels
+    stride = (width * bits + 7) // 8
+    pixels = unfilter(zlib.decompress(b"".join(idat)), width, height, max(1, bits // 8), stride)
+
+    rgba = bytearray(width * height * 4)
+    for y in range(height):
+        row = pixels[y * stride:(y + 1) * stride]
+        for x in range(width):
+            o = (y * width + x) * 4
+            if depth < 8:
+                shift = 8 - depth - (x * depth) % 8
+                v = (row[x * depth // 8] >> shift) & ((1 << depth) - 1)
+            else:
+                v = row[x * channels]
+            if color == 3:
+                rgba[o:o + 3] = palette[v * 3:v * 3 + 3]
+                rgba[o + 3] = trns[v] if trns and v < len(trns) else 255
+            elif color in (0, 4):
+                g = v * 255 // ((1 << depth) - 1)
+                rgba[o:o + 3] = bytes((g, g, g))
+                rgba[o + 3] = row[x * 2 + 1] if color == 4 else 255
+            else:
+                rgba[o:o + channels] = row[x * channels:x * channels + channels]
+                if color == 2:
+                    rgba[o + 3] = 255
+                    if trns and bytes(rgba[o:o + 3]) == bytes((trns[1], trns[3], trns[5])):
+                        rgba[o + 3] = 0
+    kind = {0: "gray", 2: "rgb", 3: "indexed", 4: "gray+alpha", 6: "rgba"}[color]
+    return width, height, rgba, "%s%d" % (kind, depth)
+
+
+def write_png(path, width, height, rgba):
+    raw = b"".join(b"\x00" + bytes(rgba[y * width * 4:(y + 1) * width * 4]) for y in range(height))
+
+    def chunk(ctype, body):
+        return struct.pack(">I", len(body)) + ctype + body + struct.pack(">I", zlib.crc32(ctype + body))
+
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+# --- Quantization -----------------------------------------------------------
+
+def expand_table(bits):
+    # SDL_ConvertSurfaceFormat truncates, the GE expands by bit replication
+    table = []
+    for v in range(256):
+        if bits == 0:
+            table.append(255)
+            continue
+        q = v >> (8 - bits)
+        e = 0
+        for shift in range(8 - bits, -bits, -bits):
+            e |= (q << shift) if shift >= 0 else (q >> -shift)
+        table.append(e & 0xFF)
+    return table
+
+
+def quantize(rgba, fmt):
+    tables = [expand_table(b) for b in FORMATS[fmt]]
+    out = bytearray(len(rgba))
+    for c in range(4):
+        t = tables[c]
+        out[c::4] = bytes(t[v] for v in rgba[c::4])
+    return out
+
+
+def compare(rgba, quant):
+    """Max channel error and PSNR over visible pixels, and how many colors collapsed."""
+    max_err = 0
+    sq = 0
+    n = 0
+    mapping = {}
+    for o in range(0, len(rgba), 4):
+        if rgba[o + 3] == 0 and quant[o + 3] == 0:
+            continue
+        src = bytes(rgba[o:o + 4])
+        dst = bytes(quant[o:o + 4])
+        mapping.setdefault(dst, set()).add(src)
+        for c in range(4):
+            d = abs(src[c] - dst[c])
+            if d > max_err:
+                max_err = d
+            sq += d * d
+        n += 4
+    colors = sum(len(s) for s in mapping.values())
+    collapsed = colors - len(mapping)
+    psnr = 99.0 if sq == 0 else 10 * math.log10(255 * 255 * n / sq)
+    return max_err, psnr, collapsed, colors
+
+
+def candidates(rgba):
+    alphas = set(rgba[3::4])
+    if alphas <= {255}:
+        return ["565", "5551"]
+    if alphas <= {0, 255}:
+        return ["5551", "4444"]
+    return ["4444"]
+
+
+def choose(rgba):
+    for fmt in candidates(rgba):
+        quant = quantize(rgba, fmt)
+        max_err, psnr, collapsed, colors = compare(rgba, quant)
+        step = 256 >> min(b for b in FORMATS[fmt] if b)
+        if colors > PHOTO_COLORS:
+            ok = psnr >= PHOTO_MIN_PSNR
+        else:
+            ok = collapsed == 0 and max_err <= step
+        if ok:
+            return fmt, quant, max_err, psnr, colors
+    return "8888", rgba, 0, 99.0, colors
+
+
+def diff_strip(width, height, rgba, quant):
+    out = bytearray(width * 3 * height * 4)
+    for y in range(height):
+        for x in range(width):
+            o = (y * width + x) * 4
+            base = (y * width * 3 + x) * 4
+            out[base:base + 4] = rgba[o:o + 4]
+            out[base + width * 4:base + width * 4 + 4] = quant[o:o + 4]
+            err = bytes(min(255, abs(rgba[o + c] - quant[o + c]) * 8) for c in range(3))
+            out[base + width * 8:base + width * 8 + 4] = err + b"\xff"
+    return out
+
+
+# --- Main -------------------------------------------------------------------
+
+def find_pngs(res_dir):
+    for dirpath, dirnames, filenames in os.walk(res_dir):
+        dirnames[:] = sorted(d for d in dirnames if d not in SKIP_DIRS)
+        for name in sorted(filenames):
+            if name.lower().endswith(".png"):
+                yield os.path.join(dirpath, name)
+
+
+def main():
+    args = sys.argv[1:]
+    diff_dir = None
+    if "--diff" in args:
+        i = args.index("--diff")
+        diff_dir = args[i + 1]
+        del args[i:i + 2]
+        os.makedirs(diff_dir, exist_ok=True)
+    root = args[0] if args else "."
+    manifest = os.path.join(root, MANIFEST)
+
+    pngs = list(find_pngs(os.path.join(root, "resources")))
+    # Skip when nothing changed so the build step stays cheap
+    if diff_dir is None and os.path.exists(manifest):
+        stamp = os.path.getmtime(manifest)
+        if all(os.path.getmtime(p) <= stamp for p in pngs):
+            return
+
+    lines = []
+    total_before = total_after = 0
+    for path in pngs:
+        rel = os.path.relpath(path, root).replace(os.sep, "/")
+        try:
+            width, height, rgba, desc = load_png(path)
+        except (ValueError, KeyError, zlib.error) as e:
+            print("%s: skipped (%s)" % (rel, e))
+            continue
+
+        fmt, quant, max_err, psnr, colors = choose(rgba)
+        before = width * height * 4
+        after = width * height * (4 if fmt == "8888" else 2)
+        total_before += before
+        total_after += after
+        lines.append("%s %s" % (rel, fmt))
+        print("%-60s %5dx%-4d %-10s %5d colors -> %-4s max err %3d, psnr %5.1f dB, %6d -> %6d bytes" % (
+            rel, width, height, desc, colors, fmt, max_err, psnr, before, after))
+
+        if diff_dir:
+            name = rel.replace("/", "_")
+            write_png(os.path.join(diff_dir, name), width * 3, height, diff_strip(width, height, rgba, quant))
+
+    with open(manifest, "w") as f:
+        f.write("# Generated by tools/texture_formats.py - texture format per asset (8888, 5551, 4444, 565)\n")
+        f.write("\n".join(lines) + "\n")
+    print("%d textures: %d -> %d bytes (unpadded)" % (len(lines), total_before, total_after))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,11 +1,24 @@
 #include "ui.h"
 #include <SDL.h>
+#include "../render/renderSnapshot.h"
+#include "../memory/memTrack.h"
 
 #define UI_BAR_X 15
 #define UI_BAR_Y 15
 #define UI_BAR_W 200
 #define UI_BAR_H 15
 
+// Cached HUD target: covers health bar + inventory row
+#define HUD_TEXTURE_W 256
+#define HUD_TEXTURE_H 80
+
+extern void debug_log(const char *format, ...);
+
+static SDL_Texture *hud_texture = NULL;
+static bool hud_dirty = true;          // update side, travels to the renderer in the snapshot
+static bool hud_target_fresh = false;  // render side: new target, nothing drawn into it yet
+static bool hud_target_failed = false; // renderer without target support -> draw directly
+
 void ui_render_health_bar(SDL_Renderer *renderer, int current_health) {
     if (current_health < 0) current_health = 0;
     if (current_health > 100) current_health = 100;
@@ -15,8 +28,8 @@ void ui_render_health_bar(SDL_Renderer *renderer, int current_health) {
         UI_BAR_W, UI_BAR_H
     };
     
-    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255); 
-    SDL_RenderFillRect(renderer, &background_rect);
+    render_set_draw_color(renderer, RENDER_SUB_UI, 50, 50, 50, 255); 
+    render_fill_rect(renderer, RENDER_SUB_UI, &background_rect);
 
 
     float health_ratio = (float)current_health / 100.0f;
@@ -40,14 +53,14 @@ void ui_render_health_bar(SDL_Renderer *renderer, int current_health) {
         r = 200; g = 0; b = 0;
     }
     
-    SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-    SDL_RenderFillRect(renderer, &health_rect);
+    render_set_draw_color(renderer, RENDER_SUB_UI, r, g, b, 255);
+    render_fill_rect(renderer, RENDER_SUB_UI, &health_rect);
 
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); 
-    SDL_RenderDrawRect(renderer, &background_rect);
+    render_set_draw_color(renderer, RENDER_SUB_UI, 255, 255, 255, 255); 
+    render_draw_rect(renderer, RENDER_SUB_UI, &background_rect);
 }
 
-void ui_render_inventory(SDL_Renderer *renderer, Item inventory[], int count) {
+void ui_render_inventory(SDL_Renderer *renderer, const Item inventory[], int count) {
     int slot_size = 32; 
     int padding = 8;
     int start_x = UI_BAR_X;
@@ -57,11 +70,11 @@ void ui_render_inventory(SDL_Renderer *renderer, Item inventory[], int count) {
         SDL_Rect slot_rect = { start_x + (slot_size + padding) * i, start_y, slot_size, slot_size };
 
         // Hintergrund & Icon
-        SDL_SetRenderDrawColor(renderer, 40, 40, 40, 200);
-        SDL_RenderFillRect(renderer, &slot_rect);
+        render_set_draw_color(renderer, RENDER_SUB_UI, 40, 40, 40, 200);
+        render_fill_rect(renderer, RENDER_SUB_UI, &slot_rect);
         
         if (inventory[i].texture) {
-            SDL_RenderCopy(renderer, inventory[i].texture, NULL, &slot_rect);
+            render_copy(renderer, RENDER_SUB_UI, inventory[i].texture, NULL, &slot_rect);
         }
 
         // STACK-COUNTER: Kleine gelbe Balken für die Anzahl
@@ -72,12 +85,76 @@ void ui_render_inventory(SDL_Renderer *renderer, Item inventory[], int count) {
                 slot_rect.y + slot_size - 6, // Am unteren Rand des Slots
                 4, 2
             };
-            SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255); // Gelb
-            SDL_RenderFillRect(renderer, &stack_dot);
+            render_set_draw_color(renderer, RENDER_SUB_UI, 255, 255, 0, 255); // Gelb
+            render_fill_rect(renderer, RENDER_SUB_UI, &stack_dot);
         }
 
         // Rahmen
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderDrawRect(renderer, &slot_rect);
+        render_set_draw_color(renderer, RENDER_SUB_UI, 255, 255, 255, 255);
+        render_draw_rect(renderer, RENDER_SUB_UI, &slot_rect);
+    }
+}
+
+void ui_mark_hud_dirty(void) {
+    hud_dirty = true;
+}
+
+bool ui_take_hud_dirty(void) {
+    bool dirty = hud_dirty;
+    hud_dirty = false;
+    return dirty;
+}
+
+static void ui_redraw_hud(SDL_Renderer *renderer, const RenderSnapshot *snap) {
+    SDL_Texture *old_target = SDL_GetRenderTarget(renderer);
+    Uint8 old_r, old_g, old_b, old_a;
+    SDL_GetRenderDrawColor(renderer, &old_r, &old_g, &old_b, &old_a);
+
+    render_set_target(renderer, RENDER_SUB_UI, hud_texture);
+    render_set_draw_color(renderer, RENDER_SUB_UI, 0, 0, 0, 0);
+    render_clear(renderer, RENDER_SUB_UI);
+
+    ui_render_health_bar(renderer, snap->health);
+    ui_render_inventory(renderer, snap->inventory, snap->inventory_count);
+
+    render_set_target(renderer, RENDER_SUB_UI, old_target);
+    render_set_draw_color(renderer, RENDER_SUB_UI, old_r, old_g, old_b, old_a);
+    hud_target_fresh = false;
+}
+
+void ui_render_hud(SDL_Renderer *renderer, const RenderSnapshot *snap) {
+    if (!renderer || !snap) return;
+
+    if (!hud_texture && !hud_target_failed) {
+        hud_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                        HUD_TEXTURE_W, HUD_TEXTURE_H);
+        if (!hud_texture) {
+            debug_log("UI_WARN: HUD Render-Target nicht verfuegbar (%s), zeichne direkt.", SDL_GetError());
+            hud_target_failed = true;
+        } else {
+            SDL_SetTextureBlendMode(hud_texture, SDL_BLENDMODE_BLEND);
+            mem_track_texture_created(hud_texture);
+            hud_target_fresh = true;
+        }
+    }
+
+    if (!hud_texture) {
+        ui_render_health_bar(renderer, snap->health);
+        ui_render_inventory(renderer, snap->inventory, snap->inventory_count);
+        return;
+    }
+
+    if (snap->hud_dirty || hud_target_fresh) ui_redraw_hud(renderer, snap);
+
+    SDL_Rect dst = {0, 0, HUD_TEXTURE_W, HUD_TEXTURE_H};
+    render_copy(renderer, RENDER_SUB_UI, hud_texture, NULL, &dst);
+}
+
+void ui_cleanup(void) {
+    if (hud_texture) {
+        mem_track_texture_destroy(hud_texture);
+        hud_texture = NULL;
     }
+    hud_target_failed = false;
+    hud_dirty = true;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <SDL.h>
 #include "../player/player.h"
 
+struct RenderSnapshot;
+
 /**
  * Zeichnet die Health Bar des Spielers.
  * * @param renderer Der SDL_Renderer.
@@ -11,5 +13,17 @@
  */
 
 void ui_render_health_bar(SDL_Renderer *renderer, int current_health);
-void ui_render_inventory(SDL_Renderer *renderer, Item inventory[], int count);
-#endif // UI_H
\ No newline at end of file
+void ui_render_inventory(SDL_Renderer *renderer, const Item inventory[], int count);
+
+/**
+ * Draws health bar and inventory from the render snapshot through a cached
+ * render target. The target is only redrawn when the snapshot carries the
+ * dirty flag (ui_mark_hud_dirty() during the update, picked up with
+ * ui_take_hud_dirty() when the snapshot is recorded), otherwise the HUD
+ * costs a single SDL_RenderCopy per frame.
+ */
+void ui_render_hud(SDL_Renderer *renderer, const struct RenderSnapshot *snap);
+void ui_mark_hud_dirty(void);
+bool ui_take_hud_dirty(void);
+void ui_cleanup(void);
+#endif // UI_H